@@ -0,0 +1,251 @@
+#include "include/activity.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+void ActivityMonitor::add_signal(const string& scope, const string& name, const void* data, int width) {
+    Signal s;
+    s.scope = scope;
+    s.name = name;
+    s.data = (const uint8_t*)data;
+    s.width = width;
+    s.bytes = width <= 8 ? 1 : width <= 16 ? 2 : 4;
+    s.word = num_words_;
+    s.bit = num_bits_;
+    signals_.push_back(s);
+    num_words_ += (width + 31) / 32;
+    num_bits_ += width;
+    prev_.assign(num_words_, 0);
+    since_.assign(num_bits_, 0);
+    primed_ = false;
+}
+
+void ActivityMonitor::set_source(const string& source) {
+    if (source == source_) return;
+    // 最后采样的周期 now_ 已计入当前上下文的 cycles，其高电平时间也属于当前上下文
+    settle_high(now_ + 1);
+    source_ = source;
+    cur_ = nullptr;
+}
+
+uint32_t ActivityMonitor::read_word(const Signal& s, size_t k) const {
+    uint32_t v = 0;
+    if (s.width <= 32) {
+        memcpy(&v, s.data, s.bytes);
+    } else {
+        memcpy(&v, s.data + 4 * k, 4);
+    }
+    int rest = s.width - 32 * (int)k;
+    return rest >= 32 ? v : v & ((1u << rest) - 1);
+}
+
+ActivityMonitor::Context& ActivityMonitor::context(TestMode mode) {
+    auto key = make_pair(source_, (int)mode);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        it = index_.emplace(key, contexts_.size()).first;
+        contexts_.emplace_back();
+        Context& c = contexts_.back();
+        c.source = source_;
+        c.mode = mode;
+        c.toggles.assign(num_bits_, 0);
+        c.high.assign(num_bits_, 0);
+    }
+    return contexts_[it->second];
+}
+
+void ActivityMonitor::settle_high(uint64_t end) {
+    if (!cur_ || !primed_) return;
+    for (const Signal& s : signals_) {
+        for (int b = 0; b < s.width; ++b) {
+            if (prev_[s.word + b / 32] >> (b % 32) & 1) {
+                size_t bit = s.bit + b;
+                cur_->high[bit] += end - since_[bit];
+                since_[bit] = end;
+            }
+        }
+    }
+}
+
+void ActivityMonitor::sample(TestMode mode, bool issued) {
+    now_++;
+    if (!cur_ || cur_->mode != mode) {
+        // 周期 now_ 属于新上下文，之前的高电平时间属于切换前的上下文
+        settle_high(now_);
+        cur_ = &context(mode);
+    }
+    Context& ctx = *cur_;
+    ctx.cycles++;
+    ctx.ops += issued;
+
+    if (!primed_) {
+        for (const Signal& s : signals_) {
+            for (size_t k = 0; k < (size_t)(s.width + 31) / 32; ++k) {
+                prev_[s.word + k] = read_word(s, k);
+            }
+        }
+        fill(since_.begin(), since_.end(), now_);
+        primed_ = true;
+        return;
+    }
+    for (const Signal& s : signals_) {
+        size_t words = (s.width + 31) / 32;
+        for (size_t k = 0; k < words; ++k) {
+            uint32_t cur = read_word(s, k);
+            uint32_t changed = cur ^ prev_[s.word + k];
+            if (!changed) continue;
+            prev_[s.word + k] = cur;
+            do {
+                int b = __builtin_ctz(changed);
+                size_t bit = s.bit + 32 * k + b;
+                ctx.toggles[bit]++;
+                if (!(cur >> b & 1)) {
+                    ctx.high[bit] += now_ - since_[bit]; // 1 -> 0
+                }
+                since_[bit] = now_;
+                changed &= changed - 1;
+            } while (changed);
+        }
+    }
+}
+
+// 文件名中只保留字母、数字、'-' 和 '_'
+static string file_token(const string& s) {
+    string out;
+    for (char c : s) {
+        bool keep = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+        if (keep) {
+            out += c;
+        } else if (!out.empty() && out.back() != '_') {
+            out += '_';
+        }
+    }
+    while (!out.empty() && out.back() == '_') out.pop_back();
+    return out.empty() ? "_" : out;
+}
+
+static vector<string> split_scope(const string& scope) {
+    vector<string> parts;
+    size_t begin = 0;
+    while (begin <= scope.size()) {
+        size_t end = scope.find('.', begin);
+        if (end == string::npos) end = scope.size();
+        if (end > begin) parts.push_back(scope.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return parts;
+}
+
+bool ActivityMonitor::write_saif(const string& path, const vector<const Context*>& contexts,
+                                 uint64_t period_ps) const {
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp) {
+        printf("Cannot open activity file %s\n", path.c_str());
+        return false;
+    }
+    uint64_t cycles = 0;
+    for (const Context* c : contexts) cycles += c->cycles;
+    bool ok = true;
+
+    fprintf(fp, "(SAIFILE\n");
+    fprintf(fp, "(SAIFVERSION \"2.0\")\n");
+    fprintf(fp, "(DIRECTION \"backward\")\n");
+    fprintf(fp, "(DESIGN \"top\")\n");
+    fprintf(fp, "(VENDOR \"vfpu\")\n");
+    fprintf(fp, "(PROGRAM_NAME \"vfpu testbench\")\n");
+    fprintf(fp, "(DIVIDER / )\n");
+    fprintf(fp, "(TIMESCALE 1 ps)\n");
+    fprintf(fp, "(DURATION %" PRIu64 ")\n", cycles * period_ps);
+
+    // 按实例路径排序后逐层打开/关闭 INSTANCE
+    vector<size_t> order(signals_.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    stable_sort(order.begin(), order.end(),
+                [&](size_t a, size_t b) { return split_scope(signals_[a].scope) < split_scope(signals_[b].scope); });
+    vector<string> open;
+    bool net_open = false;
+    for (size_t i : order) {
+        vector<string> parts = split_scope(signals_[i].scope);
+        if (!net_open || parts != open) {
+            if (net_open) fprintf(fp, "%*s)\n", 2 * (int)open.size(), ""); // NET
+            size_t common = 0;
+            while (common < open.size() && common < parts.size() && open[common] == parts[common]) common++;
+            while (open.size() > common) {
+                open.pop_back();
+                fprintf(fp, "%*s)\n", 2 * (int)open.size(), "");
+            }
+            while (open.size() < parts.size()) {
+                fprintf(fp, "%*s(INSTANCE %s\n", 2 * (int)open.size(), "", parts[open.size()].c_str());
+                open.push_back(parts[open.size()]);
+            }
+            fprintf(fp, "%*s(NET\n", 2 * (int)open.size(), "");
+            net_open = true;
+        }
+        const Signal& s = signals_[i];
+        for (int b = 0; b < s.width; ++b) {
+            uint64_t toggles = 0, high = 0;
+            for (const Context* c : contexts) {
+                toggles += c->toggles[s.bit + b];
+                high += c->high[s.bit + b];
+            }
+            char net[256];
+            if (s.width == 1) {
+                snprintf(net, sizeof(net), "%s", s.name.c_str());
+            } else {
+                snprintf(net, sizeof(net), "%s\\[%d\\]", s.name.c_str(), b);
+            }
+            if (high > cycles) {
+                // 每个上下文的高电平周期数不应超过其周期数，否则 T0 会回绕
+                printf("Activity accounting error: %s/%s high for %" PRIu64 " of %" PRIu64 " cycles in %s\n",
+                       s.scope.c_str(), net, high, cycles, path.c_str());
+                ok = false;
+                high = cycles;
+            }
+            fprintf(fp, "%*s(%s (T0 %" PRIu64 ") (T1 %" PRIu64 ") (TX 0) (TC %" PRIu64 "))\n",
+                    2 * (int)open.size() + 2, "", net, (cycles - high) * period_ps, high * period_ps, toggles);
+        }
+    }
+    if (net_open) fprintf(fp, "%*s)\n", 2 * (int)open.size(), "");
+    while (!open.empty()) {
+        open.pop_back();
+        fprintf(fp, "%*s)\n", 2 * (int)open.size(), "");
+    }
+    fprintf(fp, ")\n");
+    return fclose(fp) == 0 && ok;
+}
+
+bool ActivityMonitor::write(const ActivityOptions& opts) {
+    settle_high(now_ + 1); // 包括最后一个采样周期
+    uint64_t period_ps = (uint64_t)llround(opts.period_ns * 1000.0);
+    vector<const Context*> all;
+    for (const Context& c : contexts_) all.push_back(&c);
+    bool ok = write_saif(opts.prefix + ".saif", all, period_ps);
+    for (const Context& c : contexts_) {
+        string path = opts.prefix + "." + file_token(c.source) + "." + test_mode_name(c.mode) + ".saif";
+        ok = write_saif(path, vector<const Context*>{&c}, period_ps) && ok;
+    }
+    if (ok) {
+        printf("Switching activity written to %s.saif and %zu per-source/mode files\n", opts.prefix.c_str(),
+               contexts_.size());
+    }
+    return ok;
+}
+
+void ActivityMonitor::print_summary() const {
+    printf("\n=================================\n");
+    printf("  Switching activity (%zu signals, %zu bits)\n", signals_.size(), num_bits_);
+    printf("=================================\n");
+    printf("  %-58s %-11s %10s %10s %12s %10s\n", "source", "mode", "cycles", "ops", "toggles", "toggles/op");
+    for (const Context& c : contexts_) {
+        uint64_t toggles = 0;
+        for (uint64_t t : c.toggles) toggles += t;
+        printf("  %-58s %-11s %10" PRIu64 " %10" PRIu64 " %12" PRIu64 " %10.2f\n", c.source.c_str(),
+               test_mode_name(c.mode), c.cycles, c.ops, toggles, c.ops ? (double)toggles / c.ops : 0.0);
+    }
+    printf("=================================\n");
+}
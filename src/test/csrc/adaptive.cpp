@@ -0,0 +1,197 @@
+#include "include/adaptive.h"
+#include "include/batch_check.h"
+#include "include/format_traits.h"
+#include "include/func_coverage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_set>
+
+using namespace std;
+
+const uint64_t kAdaptiveBatch = 64; // 每轮为选中的桶生成的向量数
+
+uint64_t zero_failure_sample_size(double confidence, double max_fail_rate) {
+    return (uint64_t)ceil(log(1.0 - confidence) / log(1.0 - max_fail_rate));
+}
+
+double failure_rate_upper_bound(double confidence, uint64_t n) {
+    return n ? 1.0 - pow(1.0 - confidence, 1.0 / n) : 1.0;
+}
+
+namespace {
+
+// 运行向量并统计失败、near-miss 与新增覆盖
+class AdaptiveRunner {
+public:
+    AdaptiveRunner(Simulator& sim, const SimOptions& opts, FailureCorpus* corpus)
+        : sim_(sim), opts_(opts), corpus_(corpus) {}
+
+    // 返回 false 表示应停止 (超时或达到失败预算)
+    bool run(const vector<TestCase>& tests, BucketStats* stats) {
+        size_t n = tests.size();
+        outputs_.resize(n);
+        BucketStats dummy = {nullptr};
+        BucketStats& st = stats ? *stats : dummy;
+        uint64_t bins_before = st.new_bins;
+        st.run += n;
+        sim_.set_activity_source(stats ? bucket_name(*stats->bucket) : "directed");
+        if (!sim_.run_batch(tests.data(), n, outputs_.data())) {
+            printf("Timeout while streaming %zu test cases\n", n);
+            st.failed += n;
+            failures_ += n;
+            return false;
+        }
+
+        for (const TestCase& t : tests) {
+            bins_.clear();
+            functional_bins(t, bins_);
+            for (uint32_t bin : bins_) {
+                st.new_bins += seen_bins_.insert(bin).second;
+            }
+        }
+#ifdef COVERAGE
+        size_t num_points = 0;
+        const uint32_t* counters = sim_.coverage_counters(num_points);
+        seen_points_.resize(num_points, false);
+        for (size_t p = 0; p < num_points; ++p) {
+            if (counters[p] && !seen_points_[p]) {
+                seen_points_[p] = true;
+                st.new_bins++;
+            }
+        }
+#endif
+
+        const vector<size_t>& mismatches = checker_.fast_check(tests.data(), outputs_.data(), n);
+        size_t next = 0;
+        for (size_t k = 0; k < n; ++k) {
+            const TestCase& t = tests[k];
+            bool pass = true;
+            if (next < mismatches.size() && mismatches[next] == k) {
+                next++;
+                printf("--- Checking test case ---\n");
+                t.print_details();
+                pass = t.check_result(outputs_[k]);
+            }
+            uint32_t got = t.packed_output(outputs_[k]);
+            if (!pass) {
+                st.failed++;
+                failures_++;
+                if (corpus_) corpus_->add(t);
+                if (opts_.max_failures > 0 && failures_ >= opts_.max_failures) return false;
+            } else if (got != t.expected_bits) {
+                st.near_misses++;
+            }
+        }
+        st.last_new_bins = st.new_bins - bins_before;
+        return true;
+    }
+
+    uint64_t failures() const { return failures_; }
+
+private:
+    Simulator& sim_;
+    const SimOptions& opts_;
+    FailureCorpus* corpus_;
+    BatchChecker checker_;
+    vector<DutOutputs> outputs_;
+    vector<uint32_t> bins_;
+    unordered_set<uint32_t> seen_bins_;
+#ifdef COVERAGE
+    vector<bool> seen_points_;
+#endif
+    uint64_t failures_ = 0;
+};
+
+} // namespace
+
+int run_adaptive(Simulator& sim, const SimOptions& opts, uint32_t seed, FailureCorpus* corpus) {
+    AdaptiveRunner runner(sim, opts, corpus);
+
+    // 1. 定向测试: 全部运行，其覆盖不计入各随机桶的产出
+    TestSelection directed = opts.selection;
+    directed.num_random_tests = 0;
+    directed.test_mixed = false;
+    printf("--- Creating directed test cases ---\n");
+    vector<TestCase> tests = create_all_tests(directed);
+    printf("--- Running %zu directed test cases ---\n", tests.size());
+    bool keep_going = tests.empty() || runner.run(tests, nullptr);
+
+    // 2. 随机测试桶
+    vector<BucketStats> buckets;
+    uint64_t fixed_total = 0;
+    const TestMode modes[] = {TestMode::FP32, TestMode::FP16, TestMode::BF16, TestMode::FP16_Widen,
+                              TestMode::BF16_Widen};
+    const bool selected[] = {opts.selection.test_fp32, opts.selection.test_fp16, opts.selection.test_bf16,
+                             opts.selection.test_fp16_widen, opts.selection.test_bf16_widen};
+    for (int m = 0; m < kNumTestModes; ++m) {
+        if (!selected[m]) continue;
+        for (const RandomBucket& bucket : random_buckets(modes[m])) {
+            BucketStats st = {&bucket};
+            buckets.push_back(st);
+            fixed_total += opts.selection.num_random_tests / bucket.count_divisor;
+        }
+    }
+    const uint64_t stop_after = zero_failure_sample_size(opts.confidence, opts.max_fail_rate);
+    const uint64_t budget = opts.budget ? opts.budget : kAdaptiveBudgetFactor * fixed_total;
+
+    // 3. 每轮选择单位向量产出最高的未停止桶，尚未运行的桶优先
+    uint64_t used = 0;
+    while (keep_going && used < budget) {
+        BucketStats* best = nullptr;
+        double best_score = -1.0;
+        for (BucketStats& st : buckets) {
+            if (st.done) continue;
+            double score = st.run ? (double)(st.new_bins + st.near_misses) / st.run : HUGE_VAL;
+            if (score > best_score) {
+                best_score = score;
+                best = &st;
+            }
+        }
+        if (!best) break;
+
+        uint64_t n = min(kAdaptiveBatch, budget - used);
+        if (best->run < stop_after) n = min(n, stop_after - best->run);
+        tests.clear();
+        for (uint64_t i = 0; i < n; ++i) {
+            tests.push_back(random_bucket_test(*best->bucket));
+        }
+        keep_going = runner.run(tests, best);
+        used += n;
+        // 达到置信上界且最近一批没有新增覆盖箱时停止; 仍有新覆盖的桶继续运行
+        best->done = best->failed > 0 || (best->run >= stop_after && best->last_new_bins == 0);
+    }
+
+    // 4. 报告
+    printf("\n=================================\n");
+    printf("  Adaptive random testing\n");
+    printf("=================================\n");
+    printf("Seed %u, confidence %.3f, max failure rate %g (%llu vectors per passing bucket)\n", seed,
+           opts.confidence, opts.max_fail_rate, (unsigned long long)stop_after);
+    printf("%-58s %8s %6s %8s %9s %10s  %s\n", "Bucket", "Vectors", "Fails", "NewBins", "NearMiss",
+           "Rate<=", "Status");
+    for (const BucketStats& st : buckets) {
+        const char* status = st.failed ? "FAIL" : (st.run >= stop_after ? "bound" : "budget");
+        char bound[32] = "-";
+        if (!st.failed) snprintf(bound, sizeof(bound), "%.2e", failure_rate_upper_bound(opts.confidence, st.run));
+        printf("%-58s %8llu %6llu %8llu %9llu %10s  %s\n", bucket_name(*st.bucket).c_str(),
+               (unsigned long long)st.run, (unsigned long long)st.failed, (unsigned long long)st.new_bins,
+               (unsigned long long)st.near_misses, bound, status);
+    }
+    printf("Random vectors: %llu of budget %llu (fixed allocation: %llu)\n", (unsigned long long)used,
+           (unsigned long long)budget, (unsigned long long)fixed_total);
+    printf("=================================\n");
+
+    if (runner.failures() > 0) {
+        printf("\n=================================\n");
+        printf("      TEST FAILED!\n");
+        printf("=================================\n");
+        return 1;
+    }
+    printf("\n=================================\n");
+    printf("      ALL TESTS PASSED!\n");
+    printf("=================================\n");
+    return 0;
+}
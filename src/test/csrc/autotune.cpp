@@ -0,0 +1,179 @@
+#include "include/autotune.h"
+#include "include/simulator.h"
+#include "include/test_factory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+bool benchmark_split(const SimOptions& opts, const vector<TestCase>& tests, unsigned instances,
+                     unsigned threads, AutotuneResult& result) {
+    // 模型在计时之外创建，线程池的启动开销不计入
+    vector<char*> args = opts.verilator_args;
+    vector<unique_ptr<Simulator>> sims;
+    for (unsigned k = 0; k < instances; ++k) {
+        sims.emplace_back(new Simulator((int)args.size(), args.data(), threads));
+    }
+    result.model_threads = sims[0]->model_threads();
+    result.instances = instances;
+    result.ops = tests.size();
+
+    atomic<bool> ok(true);
+    auto worker = [&](unsigned k) {
+        size_t begin = tests.size() * k / instances;
+        size_t end = tests.size() * (k + 1) / instances;
+        vector<DutOutputs> outputs(opts.batch_size);
+        for (size_t pos = begin; pos < end; pos += opts.batch_size) {
+            size_t count = min((size_t)opts.batch_size, end - pos);
+            if (!sims[k]->run_batch(tests.data() + pos, count, outputs.data())) {
+                ok = false;
+                return;
+            }
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (unsigned k = 0; k < instances; ++k) {
+        workers.emplace_back(worker, k);
+    }
+    for (thread& t : workers) {
+        t.join();
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+bool read_autotune_file(const string& path, vector<AutotuneResult>& results) {
+    ifstream in(path);
+    if (!in) {
+        return false; // 第一次运行时文件不存在
+    }
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream ss(line);
+        AutotuneResult r;
+        if (!(ss >> r.model_threads >> r.instances >> r.ops >> r.seconds)) {
+            printf("Malformed line in %s: %s\n", path.c_str(), line.c_str());
+            return false;
+        }
+        results.push_back(r);
+    }
+    return true;
+}
+
+bool append_autotune_file(const string& path, const vector<AutotuneResult>& results) {
+    FILE* fp = fopen(path.c_str(), "a");
+    if (!fp) {
+        printf("Cannot open autotune file %s\n", path.c_str());
+        return false;
+    }
+    if (ftell(fp) == 0) {
+        fprintf(fp, "# model_threads instances ops seconds\n");
+    }
+    for (const AutotuneResult& r : results) {
+        fprintf(fp, "%u %u %llu %.6f\n", r.model_threads, r.instances, (unsigned long long)r.ops, r.seconds);
+    }
+    return fclose(fp) == 0;
+}
+
+static void print_result(const AutotuneResult& r, double baseline) {
+    printf("  %13u %9u %9u %14.0f %8.2fx\n", r.model_threads, r.instances, r.model_threads * r.instances,
+           r.ops_per_sec(), baseline > 0 ? r.ops_per_sec() / baseline : 0.0);
+}
+
+int run_autotune(const SimOptions& opts) {
+    unsigned cores = opts.autotune_cores ? opts.autotune_cores : thread::hardware_concurrency();
+    if (cores == 0) cores = 1;
+
+    // 向量集: 选定模式的测试集，重复到 autotune_ops 个
+    printf("--- Creating autotune workload ---\n");
+    vector<TestCase> suite = create_all_tests(opts.selection);
+    if (suite.empty()) {
+        printf("The autotune workload is empty, select modes with --modes and a positive --count\n");
+        return 1;
+    }
+    vector<TestCase> tests;
+    tests.reserve(opts.autotune_ops);
+    while (tests.size() < opts.autotune_ops) {
+        size_t n = min(suite.size(), (size_t)opts.autotune_ops - tests.size());
+        tests.insert(tests.end(), suite.begin(), suite.begin() + n);
+    }
+
+    unsigned model_threads = Simulator::verilated_threads();
+    unsigned threads = max(opts.threads, model_threads);
+    unsigned max_instances = max(1u, cores / threads);
+    printf("--- %zu ops, %u cores, model verilated with --threads %u ---\n\n", tests.size(), cores,
+           model_threads);
+
+    // 实例数: 1, 2, 4, ... 以及 max_instances
+    vector<unsigned> splits;
+    for (unsigned n = 1; n < max_instances; n *= 2) {
+        splits.push_back(n);
+    }
+    splits.push_back(max_instances);
+
+    vector<AutotuneResult> measured;
+    for (unsigned n : splits) {
+        AutotuneResult r;
+        if (!benchmark_split(opts, tests, n, threads, r)) {
+            printf("Timeout while benchmarking %u instances\n", n);
+            return 1;
+        }
+        printf("  %u instance(s) x %u thread(s): %.0f ops/s\n", n, threads, r.ops_per_sec());
+        measured.push_back(r);
+    }
+
+    // 同一划分有多次测量时取最近一次
+    vector<AutotuneResult> history;
+    if (!opts.autotune_path.empty()) {
+        read_autotune_file(opts.autotune_path, history);
+        if (!append_autotune_file(opts.autotune_path, measured)) {
+            return 1;
+        }
+    }
+    history.insert(history.end(), measured.begin(), measured.end());
+    map<pair<unsigned, unsigned>, AutotuneResult> latest;
+    for (const AutotuneResult& r : history) {
+        latest[make_pair(r.model_threads, r.instances)] = r;
+    }
+    vector<AutotuneResult> all;
+    for (const auto& kv : latest) {
+        all.push_back(kv.second);
+    }
+
+    // 以单实例、单线程模型 (没有时取最慢的结果) 为基准
+    double baseline = 0;
+    for (const AutotuneResult& r : all) {
+        if (r.model_threads == 1 && r.instances == 1) baseline = r.ops_per_sec();
+    }
+    if (baseline == 0) {
+        for (const AutotuneResult& r : all) {
+            if (baseline == 0 || r.ops_per_sec() < baseline) baseline = r.ops_per_sec();
+        }
+    }
+    sort(all.begin(), all.end(),
+         [](const AutotuneResult& a, const AutotuneResult& b) { return a.ops_per_sec() > b.ops_per_sec(); });
+
+    printf("\n=================================\n");
+    printf("  Thread split autotune (%u cores)\n", cores);
+    printf("=================================\n");
+    printf("  %13s %9s %9s %14s %9s\n", "model threads", "instances", "cores", "ops/s", "speedup");
+    for (const AutotuneResult& r : all) {
+        print_result(r, baseline);
+    }
+    const AutotuneResult& best = all.front();
+    printf("Best split: %u instance(s) of a --threads %u model (run with --shard I/%u, --threads %u)\n",
+           best.instances, best.model_threads, best.instances, best.model_threads);
+    printf("=================================\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "include/batch_check.h"
+#include "include/format_traits.h"
+#include "include/perf_trace.h"
+
+// 快速路径允许的ULP误差: 与 check_mode<M, E> 中的判定一致。
+// RelativeError 需要浮点计算，快速路径只接受精确匹配 (limit = 0)。
+template <TestMode M>
+static constexpr uint32_t fast_ulp_limit(ErrorType e) {
+    return (e == ErrorType::ULP || e == ErrorType::ULP_or_RelativeError
+            || (ModeTraits<M>::is_widen && e != ErrorType::Precise))
+           ? ModeTraits<M>::res_format::ulp_limit : 0;
+}
+
+static const uint32_t kUlpLimit[kNumTestModes][kNumErrorTypes] = {
+#define ULP_ROW(M) { fast_ulp_limit<M>(ErrorType::Precise), fast_ulp_limit<M>(ErrorType::ULP), \
+                     fast_ulp_limit<M>(ErrorType::RelativeError), fast_ulp_limit<M>(ErrorType::ULP_or_RelativeError) }
+    ULP_ROW(TestMode::FP32),
+    ULP_ROW(TestMode::FP16),
+    ULP_ROW(TestMode::BF16),
+    ULP_ROW(TestMode::FP16_Widen),
+    ULP_ROW(TestMode::BF16_Widen),
+#undef ULP_ROW
+};
+
+// 没有判定规则的组合总是不通过，快速路径不接受 (掩码为0)，全部交给慢路径
+static const uint32_t kFastMask[kNumTestModes][kNumErrorTypes] = {
+#define MASK_ROW(M) { has_check_rule<M>(ErrorType::Precise) ? 0xFFFFFFFFu : 0, \
+                      has_check_rule<M>(ErrorType::ULP) ? 0xFFFFFFFFu : 0, \
+                      has_check_rule<M>(ErrorType::RelativeError) ? 0xFFFFFFFFu : 0, \
+                      has_check_rule<M>(ErrorType::ULP_or_RelativeError) ? 0xFFFFFFFFu : 0 }
+    MASK_ROW(TestMode::FP32),
+    MASK_ROW(TestMode::FP16),
+    MASK_ROW(TestMode::BF16),
+    MASK_ROW(TestMode::FP16_Widen),
+    MASK_ROW(TestMode::BF16_Widen),
+#undef MASK_ROW
+};
+
+static inline uint32_t abs_diff(uint32_t a, uint32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+const std::vector<size_t>& BatchChecker::fast_check(const TestCase* tests, const DutOutputs* outputs, size_t n) {
+    TRACE_SCOPE("BatchChecker::fast_check");
+    expected_.resize(n);
+    got_.resize(n);
+    ulp_limit_.resize(n);
+    dual_.resize(n);
+    fast_mask_.resize(n);
+    ok_.resize(n);
+    mismatches_.clear();
+
+    // 1. AoS -> SoA: 双路16位结果按 {res_out_16_1, res_out_16_0} 打包，与 expected_bits 对齐
+    for (size_t i = 0; i < n; ++i) {
+        const TestCase& t = tests[i];
+        bool dual = (t.mode == TestMode::FP16 || t.mode == TestMode::BF16);
+        expected_[i] = t.expected_bits;
+        got_[i] = dual ? (((uint32_t)outputs[i].res_out_16_1 << 16) | outputs[i].res_out_16_0)
+                       : outputs[i].res_out_32;
+        ulp_limit_[i] = kUlpLimit[(int)t.mode][(int)t.error_type];
+        dual_[i] = dual ? 0xFFFFFFFFu : 0;
+        fast_mask_[i] = kFastMask[(int)t.mode][(int)t.error_type];
+    }
+
+    // 2. 无分支比较，便于编译器向量化
+    const uint32_t* e = expected_.data();
+    const uint32_t* g = got_.data();
+    const uint32_t* lim = ulp_limit_.data();
+    const uint32_t* dual = dual_.data();
+    const uint32_t* mask = fast_mask_.data();
+    uint8_t* ok = ok_.data();
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t ei = e[i], gi = g[i], li = lim[i];
+        // 32位结果
+        uint32_t ok32 = (abs_diff(ei, gi) <= li) | (((ei | gi) & 0x7FFFFFFFu) == 0);
+        // 两路16位结果
+        uint32_t e0 = ei & 0xFFFF, g0 = gi & 0xFFFF, e1 = ei >> 16, g1 = gi >> 16;
+        uint32_t ok0 = (abs_diff(e0, g0) <= li) | (((e0 | g0) & 0x7FFFu) == 0);
+        uint32_t ok1 = (abs_diff(e1, g1) <= li) | (((e1 | g1) & 0x7FFFu) == 0);
+        ok[i] = (uint8_t)(((ok32 & ~dual[i]) | (ok0 & ok1 & dual[i])) & mask[i]);
+    }
+
+    // 3. 收集需要走慢路径的下标
+    for (size_t i = 0; i < n; ++i) {
+        if (!ok[i]) mismatches_.push_back(i);
+    }
+    checked_ += n;
+    slow_path_ += mismatches_.size();
+    return mismatches_;
+}
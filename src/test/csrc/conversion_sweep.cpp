@@ -0,0 +1,184 @@
+#include "include/conversion_sweep.h"
+#include "include/fp_utils.h"
+#include "include/softfloat_ref.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+const size_t kMaxReported = 8;          // 每种转换列出的不一致个数
+const uint64_t kSweepBlock = 1 << 20;   // 每次分给线程的输入个数
+const uint64_t kSweepEnd = 1ull << 32;
+const size_t kRefChunk = 4096;          // 参考转换每次批量计算的输入个数
+
+static bool is_nan32(uint32_t b) { return (b & 0x7F800000) == 0x7F800000 && (b & 0x007FFFFF); }
+static bool is_nan16(uint16_t b) { return (b & 0x7C00) == 0x7C00 && (b & 0x03FF); }
+static bool is_nan_bf16(uint16_t b) { return (b & 0x7F80) == 0x7F80 && (b & 0x007F); }
+
+static uint32_t float_bits(float f) {
+    uint32_t b;
+    memcpy(&b, &f, sizeof(b));
+    return b;
+}
+
+static double bf16_value(uint16_t b) {
+    // 0x7F80 作为舍入候选时代表 2^128 (IEEE 754 向无穷舍入的判定点)
+    if ((b & 0x7FFF) == 0x7F80) return (b & 0x8000) ? -ldexp(1.0, 128) : ldexp(1.0, 128);
+    uint32_t f = (uint32_t)b << 16;
+    float v;
+    memcpy(&v, &f, sizeof(v));
+    return v;
+}
+
+uint16_t reference_fp32_to_bf16(uint32_t bits) {
+    if (is_nan32(bits)) {
+        return (uint16_t)(bits >> 16) | 0x0040;
+    }
+    uint16_t lo = (uint16_t)(bits >> 16); // 向零截断
+    if ((bits & 0xFFFF) == 0 || (lo & 0x7FFF) == 0x7F80) {
+        return lo; // 精确或无穷大
+    }
+    uint16_t hi = lo + 1;                 // 绝对值更大的相邻值 (最大有限数之后为无穷大)
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    double dlo = fabs((double)x - bf16_value(lo));
+    double dhi = fabs(bf16_value(hi) - (double)x);
+    if (dlo != dhi) return dlo < dhi ? lo : hi;
+    return (lo & 1) ? hi : lo;
+}
+
+// 单个线程的记录，结束时合并
+struct SweepRecord {
+    uint64_t tested = 0;
+    uint64_t mismatches = 0;
+    vector<ConversionMismatch> first;
+
+    void add(uint32_t input, uint32_t got, uint32_t expected) {
+        mismatches++;
+        if (first.size() < kMaxReported) first.push_back(ConversionMismatch{input, got, expected});
+    }
+};
+
+static void merge(ConversionResult& r, const SweepRecord& rec) {
+    r.tested += rec.tested;
+    r.mismatches += rec.mismatches;
+    r.first.insert(r.first.end(), rec.first.begin(), rec.first.end());
+    sort(r.first.begin(), r.first.end(),
+         [](const ConversionMismatch& a, const ConversionMismatch& b) { return a.input < b.input; });
+    if (r.first.size() > kMaxReported) r.first.resize(kMaxReported);
+}
+
+// 16位输入: 单线程即可
+static void sweep_16(ConversionResult& to32_fp16, ConversionResult& to32_bf16) {
+    SweepRecord fp16, bf16;
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        uint32_t got = float_bits(fp16_to_fp32((uint16_t)h));
+        uint32_t expected = reference_f16_to_f32((uint16_t)h);
+        fp16.tested++;
+        bool same = is_nan16((uint16_t)h) ? is_nan32(got) && (got >> 31) == (expected >> 31) : got == expected;
+        if (!same) fp16.add(h, got, expected);
+
+        got = float_bits(bf16_to_fp32((uint16_t)h));
+        expected = h << 16;
+        bf16.tested++;
+        same = is_nan_bf16((uint16_t)h) ? is_nan32(got) && (got >> 31) == (expected >> 31) : got == expected;
+        if (!same) bf16.add(h, got, expected);
+    }
+    merge(to32_fp16, fp16);
+    merge(to32_bf16, bf16);
+}
+
+static void sweep_32_block(uint64_t begin, uint64_t end, uint64_t step, SweepRecord& fp16, SweepRecord& bf16) {
+    uint32_t inputs[kRefChunk];
+    uint16_t ref_fp16[kRefChunk];
+    uint64_t i = begin;
+    while (i < end) {
+        // 参考结果分批计算，参考引擎每批只加一次锁
+        size_t n = 0;
+        for (; n < kRefChunk && i < end; ++n, i += step) {
+            inputs[n] = (uint32_t)i;
+        }
+        reference_f32_to_f16_batch(inputs, ref_fp16, n);
+
+        for (size_t k = 0; k < n; ++k) {
+            uint32_t bits = inputs[k];
+            float x;
+            memcpy(&x, &bits, sizeof(x));
+
+            uint16_t got = fp32_to_fp16(x);
+            uint16_t expected = ref_fp16[k];
+            fp16.tested++;
+            bool same = is_nan32(bits) ? is_nan16(got) && (got >> 15) == (expected >> 15) : got == expected;
+            if (!same) fp16.add(bits, got, expected);
+
+            got = fp32_to_bf16(x);
+            expected = reference_fp32_to_bf16(bits);
+            bf16.tested++;
+            same = is_nan32(bits) ? is_nan_bf16(got) && (got >> 15) == (expected >> 15) : got == expected;
+            if (!same) bf16.add(bits, got, expected);
+        }
+    }
+}
+
+static void print_result(const ConversionResult& r, int in_digits, int out_digits) {
+    printf("  %-14s %12llu tested  %10llu mismatches  %s\n", r.name, (unsigned long long)r.tested,
+           (unsigned long long)r.mismatches, r.mismatches ? "FAIL" : "ok");
+    for (const ConversionMismatch& m : r.first) {
+        printf("      input 0x%0*X: got 0x%0*X, expected 0x%0*X\n", in_digits, m.input, out_digits, m.got, out_digits,
+               m.expected);
+    }
+}
+
+int run_conversion_sweep(unsigned threads, uint64_t step) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    if (step == 0) step = 1;
+
+    ConversionResult fp16_to32, bf16_to32, to_fp16, to_bf16;
+    fp16_to32.name = "fp16_to_fp32";
+    bf16_to32.name = "bf16_to_fp32";
+    to_fp16.name = "fp32_to_fp16";
+    to_bf16.name = "fp32_to_bf16";
+
+    auto start = chrono::steady_clock::now();
+    sweep_16(fp16_to32, bf16_to32);
+
+    // 2^32 个输入按块动态分配; 块大小是 step 的倍数，保证跨块时步长不变
+    const uint64_t block = max(kSweepBlock / step, (uint64_t)1) * step;
+    atomic<uint64_t> next(0);
+    mutex merge_lock;
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            SweepRecord fp16, bf16;
+            uint64_t begin;
+            while ((begin = next.fetch_add(block)) < kSweepEnd) {
+                sweep_32_block(begin, min(begin + block, kSweepEnd), step, fp16, bf16);
+            }
+            lock_guard<mutex> guard(merge_lock);
+            merge(to_fp16, fp16);
+            merge(to_bf16, bf16);
+        });
+    }
+    for (thread& t : workers) {
+        t.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("\n=================================\n");
+    printf("  Conversion sweep (%u threads, step %llu, %.1f s)\n", threads, (unsigned long long)step, seconds);
+    printf("=================================\n");
+    print_result(fp16_to32, 4, 8);
+    print_result(bf16_to32, 4, 8);
+    print_result(to_fp16, 8, 4);
+    print_result(to_bf16, 8, 4);
+    printf("=================================\n");
+    bool ok = !fp16_to32.mismatches && !bf16_to32.mismatches && !to_fp16.mismatches && !to_bf16.mismatches;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "include/coverage_db.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <tuple>
+
+using namespace std;
+
+// 取出覆盖点 key 串中某个字段的值，不存在时返回空串
+static string key_field(const string& key, const char* name) {
+    string tag = string("\001") + name + "\002";
+    size_t pos = key.find(tag);
+    if (pos == string::npos) return string();
+    pos += tag.size();
+    size_t end = key.find('\001', pos);
+    return key.substr(pos, end == string::npos ? string::npos : end - pos);
+}
+
+bool read_coverage_file(const string& path, CoverageDb& db) {
+    ifstream in(path);
+    if (!in) {
+        printf("Cannot open coverage file %s\n", path.c_str());
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        // C '<key>' <count>，key 中可能含有空格，以最后一个单引号为界
+        size_t close = line.rfind('\'');
+        if (line.compare(0, 3, "C '") != 0 || close == string::npos || close < 3) {
+            printf("Malformed line in %s: %s\n", path.c_str(), line.c_str());
+            return false;
+        }
+        char* end = nullptr;
+        const char* count_text = line.c_str() + close + 1;
+        uint64_t count = strtoull(count_text, &end, 10);
+        if (end == count_text) {
+            printf("Malformed line in %s: %s\n", path.c_str(), line.c_str());
+            return false;
+        }
+        db[line.substr(3, close - 3)] += count;
+    }
+    return true;
+}
+
+bool write_coverage_file(const string& path, const CoverageDb& db) {
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp) {
+        printf("Cannot open coverage file %s\n", path.c_str());
+        return false;
+    }
+    fprintf(fp, "# SystemC::Coverage-3\n");
+    for (const auto& point : db) {
+        fprintf(fp, "C '%s' %llu\n", point.first.c_str(), (unsigned long long)point.second);
+    }
+    return fclose(fp) == 0;
+}
+
+// ===================================================================
+// 按模块统计
+// ===================================================================
+// 同一模块的多个实例合并统计: 任一实例命中即认为该行/信号已覆盖
+struct CoverageSite {
+    string file;
+    long line;
+    string comment;
+    bool operator<(const CoverageSite& o) const {
+        return tie(file, line, comment) < tie(o.file, o.line, o.comment);
+    }
+};
+
+void print_coverage_report(const CoverageDb& db, size_t max_list) {
+    // (模块, 类型) -> 覆盖点 -> 各实例计数之和
+    map<pair<string, string>, map<CoverageSite, uint64_t>> groups;
+    for (const auto& point : db) {
+        string page = key_field(point.first, "page");
+        size_t slash = page.find('/');
+        string type = page.substr(0, slash);
+        if (type.compare(0, 2, "v_") == 0) type = type.substr(2);
+        string module = slash == string::npos ? string("?") : page.substr(slash + 1);
+        CoverageSite site = {key_field(point.first, "f"), atol(key_field(point.first, "l").c_str()),
+                             key_field(point.first, "o")};
+        groups[make_pair(module, type)][site] += point.second;
+    }
+
+    printf("\n=================================\n");
+    printf("  RTL coverage report (%zu points)\n", db.size());
+    printf("=================================\n");
+    printf("%-24s %-8s %10s %10s %8s\n", "Module", "Type", "Covered", "Total", "Percent");
+    for (const auto& group : groups) {
+        size_t covered = 0;
+        for (const auto& site : group.second) {
+            if (site.second) covered++;
+        }
+        size_t total = group.second.size();
+        printf("%-24s %-8s %10zu %10zu %7.1f%%\n", group.first.first.c_str(), group.first.second.c_str(),
+               covered, total, total ? 100.0 * covered / total : 0.0);
+    }
+
+    for (const auto& group : groups) {
+        size_t listed = 0, uncovered = 0;
+        for (const auto& site : group.second) {
+            if (site.second) continue;
+            if (uncovered++ == 0) {
+                printf("\n--- Uncovered %s in %s ---\n", group.first.second.c_str(), group.first.first.c_str());
+            }
+            if (max_list == 0 || listed < max_list) {
+                printf("  %s:%ld  %s\n", site.first.file.c_str(), site.first.line, site.first.comment.c_str());
+                listed++;
+            }
+        }
+        if (uncovered > listed) {
+            printf("  ... and %zu more\n", uncovered - listed);
+        }
+    }
+    printf("=================================\n");
+}
+
+int merge_coverage_files(const vector<string>& inputs, const string& output_path) {
+    CoverageDb db;
+    for (const string& path : inputs) {
+        if (!read_coverage_file(path, db)) {
+            return 1;
+        }
+    }
+    print_coverage_report(db);
+    if (!output_path.empty() && !write_coverage_file(output_path, db)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "include/failure_corpus.h"
+#include "include/simulator.h"
+#include "include/options.h"
+#include "include/batch_check.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+static const char* error_type_name(ErrorType e) {
+    switch (e) {
+        case ErrorType::Precise:              return "precise";
+        case ErrorType::ULP:                  return "ulp";
+        case ErrorType::RelativeError:        return "relative";
+        case ErrorType::ULP_or_RelativeError: return "ulp_or_relative";
+    }
+    return "unknown";
+}
+
+static bool parse_error_type(const string& name, ErrorType& e) {
+    const ErrorType types[] = {ErrorType::Precise, ErrorType::ULP, ErrorType::RelativeError,
+                               ErrorType::ULP_or_RelativeError};
+    for (ErrorType t : types) {
+        if (name == error_type_name(t)) {
+            e = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Widen 模式的低16位不是操作数，清零后再去重
+static uint32_t operand_mask(TestMode mode) {
+    return (mode == TestMode::FP16_Widen || mode == TestMode::BF16_Widen) ? 0xFFFF0000 : 0xFFFFFFFF;
+}
+
+FailureCorpus::~FailureCorpus() {
+    if (append_) fclose(append_);
+}
+
+bool FailureCorpus::insert(const TestCase& test) {
+    if (!keys_.insert(make_tuple(test.mode, test.a_bits, test.b_bits)).second) {
+        return false;
+    }
+    tests_.push_back(test);
+    return true;
+}
+
+bool FailureCorpus::load(const string& path) {
+    path_ = path;
+    ifstream in(path);
+    if (!in) {
+        return true;
+    }
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream ss(line);
+        string mode_name, error_name;
+        uint32_t a, b;
+        TestMode mode;
+        ErrorType error_type;
+        if (!(ss >> mode_name >> hex >> a >> b >> error_name) || !parse_test_mode(mode_name.c_str(), mode)
+            || !parse_error_type(error_name, error_type)) {
+            printf("Malformed line in %s: %s\n", path.c_str(), line.c_str());
+            return false;
+        }
+        TestCase t(FADD_Operands_Hex{0, 0}, error_type);
+        t.mode = mode;
+        t.a_bits = a & operand_mask(mode);
+        t.b_bits = b & operand_mask(mode);
+        insert(t);
+    }
+    return true;
+}
+
+bool FailureCorpus::add(const TestCase& test) {
+    TestCase t = test;
+    t.a_bits &= operand_mask(t.mode);
+    t.b_bits &= operand_mask(t.mode);
+    if (path_.empty() || !insert(t)) {
+        return false;
+    }
+    if (!append_) {
+        append_ = fopen(path_.c_str(), "a");
+        if (!append_) {
+            printf("Cannot open failure corpus %s\n", path_.c_str());
+            return false;
+        }
+    }
+    // 整行一次写入并立即刷新，进程随后崩溃或超时也不会丢失
+    char line[64];
+    int len = snprintf(line, sizeof(line), "%s %08x %08x %s\n", test_mode_name(t.mode), t.a_bits, t.b_bits,
+                       error_type_name(t.error_type));
+    fwrite(line, 1, len, append_);
+    fflush(append_);
+    added_++;
+    return true;
+}
+
+int64_t replay_corpus(Simulator& sim, const FailureCorpus& corpus, const SimOptions& opts) {
+    vector<TestCase> tests;
+    for (size_t k = opts.shard_index; k < corpus.tests().size(); k += opts.shard_count) {
+        tests.push_back(corpus.tests()[k]);
+        tests.back().compute_expected();
+    }
+    if (tests.empty()) {
+        return 0;
+    }
+    printf("--- Replaying %zu failure corpus vectors from %s ---\n", tests.size(), corpus.path().c_str());
+
+    vector<DutOutputs> outputs(tests.size());
+    BatchChecker checker;
+    int64_t failed = 0;
+    for (size_t pos = 0; pos < tests.size(); pos += opts.batch_size) {
+        size_t count = min((size_t)opts.batch_size, tests.size() - pos);
+        if (!sim.run_batch(tests.data() + pos, count, outputs.data() + pos)) {
+            printf("Timeout while replaying failure corpus vectors %zu..%zu\n", pos + 1, pos + count);
+            return -1;
+        }
+        const vector<size_t>& mismatches = checker.fast_check(tests.data() + pos, outputs.data() + pos, count);
+        for (size_t k : mismatches) {
+            printf("--- Checking failure corpus vector %zu ---\n", pos + k + 1);
+            tests[pos + k].print_details();
+            if (!tests[pos + k].check_result(outputs[pos + k])) {
+                failed++;
+            }
+        }
+    }
+    printf("Failure corpus: %zu vectors replayed, %lld failed\n\n", tests.size(), (long long)failed);
+    return failed;
+}
@@ -106,10 +106,13 @@ uint16_t fp32_to_fp16(float fp32) {
                 int shift = 1 - fp16_exp;               // 需要右移的位数
                 
                 // 执行右移，包含舍入
-                uint32_t shifted_frac = full_frac >> (shift + (23 - 10));
+                int drop = shift + (23 - 10);           // 被移出的位数
+                uint32_t shifted_frac = full_frac >> drop;
+                uint32_t guard = (full_frac >> (drop - 1)) & 1;
+                uint32_t sticky = full_frac & ((1u << (drop - 1)) - 1);
                 
-                // 简单的舍入到最近偶数
-                if (full_frac & (1 << (shift + (23 - 10) - 1))) {
+                // 舍入到最近偶数: 超过一半，或恰好一半且结果为奇数时进位
+                if (guard && (sticky || (shifted_frac & 1))) {
                     shifted_frac++;
                 }
                 
@@ -126,8 +129,10 @@ uint16_t fp32_to_fp16(float fp32) {
             // 尾数转换：从23位缩减到10位，包含舍入
             uint32_t fp16_frac = frac >> (23 - 10);  // 截取高10位
             
-            // 简单的舍入到最近偶数
-            if (frac & (1 << (23 - 10 - 1))) {  // 检查被截掉的最高位
+            // 舍入到最近偶数: 被截掉的最高位为1，且其余位非零或结果为奇数时进位
+            uint32_t guard = frac & (1 << (23 - 10 - 1));
+            uint32_t sticky = frac & ((1 << (23 - 10 - 1)) - 1);
+            if (guard && (sticky || (fp16_frac & 1))) {
                 fp16_frac++;
                 
                 // 检查舍入后是否溢出
@@ -177,6 +182,11 @@ uint16_t fp32_to_bf16(float fp32) {
     // 2. 根据低16位进行RNE舍入
     uint16_t high16 = (uint16_t)(fp32_bits >> 16);
     uint16_t low16 = (uint16_t)(fp32_bits & 0xFFFF);
+
+    // NaN: 不能参与舍入 (尾数进位会变成无穷大或改变符号)，保留符号与高位载荷并置为 quiet NaN
+    if ((fp32_bits & 0x7F800000) == 0x7F800000 && (fp32_bits & 0x007FFFFF)) {
+        return high16 | 0x0040;
+    }
     
     // RNE舍入逻辑：需要检查guard, round, sticky位
     uint32_t guard_bit = (low16 >> 15) & 1;        // 低16位的最高位
@@ -0,0 +1,92 @@
+#include "include/func_coverage.h"
+#include "include/format_traits.h"
+
+#include <cstdlib>
+
+enum OperandClass : uint32_t { kZero, kSubnormal, kNormal, kInf, kNaN, kNumClasses };
+
+// 按格式拆分位模式的各个字段
+template <class F>
+struct Fields {
+    static constexpr uint32_t exp_max = (1u << F::exp_bits) - 1;
+    static constexpr int bias = (1 << (F::exp_bits - 1)) - 1;
+
+    static uint32_t sign(uint32_t bits) { return (bits >> (F::exp_bits + F::man_bits)) & 1; }
+    static uint32_t exp(uint32_t bits) { return (bits >> F::man_bits) & exp_max; }
+    static uint32_t man(uint32_t bits) { return bits & ((1u << F::man_bits) - 1); }
+    static uint32_t cls(uint32_t bits) {
+        if (exp(bits) == 0) return man(bits) ? kSubnormal : kZero;
+        if (exp(bits) == exp_max) return man(bits) ? kNaN : kInf;
+        return kNormal;
+    }
+    // 去偏置的指数，非规格化数与最小规格化数相同
+    static int unbiased_exp(uint32_t bits) { return (exp(bits) ? (int)exp(bits) : 1) - bias; }
+};
+
+// 0 -> 0, 1 -> 1, 2..3 -> 2, 4..7 -> 3, ...，最大为 7
+static uint32_t log_bucket(uint32_t d) {
+    uint32_t b = 0;
+    while (d && b < 7) {
+        b++;
+        d >>= 1;
+    }
+    return b;
+}
+
+template <TestMode M>
+static void lane_bins(uint32_t a, uint32_t b, uint32_t r, uint32_t lane, std::vector<uint32_t>& bins) {
+    typedef typename ModeTraits<M>::in_format In;
+    typedef typename ModeTraits<M>::res_format Res;
+    typedef Fields<In> I;
+    typedef Fields<Res> R;
+    const uint32_t base = ((uint32_t)M << 24) | (lane << 20);
+    auto add = [&](CoverageFeature f, uint32_t v) { bins.push_back(base | ((uint32_t)f << 16) | v); };
+
+    uint32_t ca = I::cls(a), cb = I::cls(b), cr = R::cls(r);
+    add(CoverageFeature::Class, ca * kNumClasses + cb);
+    add(CoverageFeature::Result, cr * 2 + R::sign(r));
+    if (ca >= kInf || cb >= kInf) return; // 特殊值不经过对阶/规格化数据通路
+
+    // 对阶: 指数差超过 man_bits + 2 时较小的操作数整体移出到 sticky 位
+    uint32_t eff_sub = I::sign(a) != I::sign(b);
+    int ea = I::unbiased_exp(a), eb = I::unbiased_exp(b);
+    uint32_t d = (uint32_t)abs(ea - eb);
+    uint32_t all_sticky = d > (uint32_t)In::man_bits + 2;
+    add(CoverageFeature::Align, (eff_sub << 4) | (all_sticky << 3) | log_bucket(d));
+
+    if (cr != kNormal && cr != kSubnormal) return;
+    // 规格化: 结果指数相对较大操作数指数的变化，-1 表示加法进位
+    int shift = (ea > eb ? ea : eb) - R::unbiased_exp(r);
+    add(CoverageFeature::Norm, (eff_sub << 4) | (shift < 0 ? 0 : 1 + log_bucket((uint32_t)shift)));
+
+    // 舍入: 精确和 (double 计算) 与结果不同即发生了舍入，并区分结果尾数最低位
+    double exact = (double)In::to_fp32((typename In::bits_t)a) + (double)In::to_fp32((typename In::bits_t)b);
+    uint32_t inexact = (exact != (double)Res::to_fp32((typename Res::bits_t)r))
+                       || (all_sticky && ca != kZero && cb != kZero);
+    add(CoverageFeature::Round, inexact | ((r & 1) << 1));
+}
+
+void functional_bins(const TestCase& test, std::vector<uint32_t>& bins) {
+    switch (test.mode) {
+        case TestMode::FP32:
+            lane_bins<TestMode::FP32>(test.a_bits, test.b_bits, test.expected_bits, 0, bins);
+            break;
+        case TestMode::FP16:
+            for (uint32_t lane = 0; lane < 2; ++lane) {
+                lane_bins<TestMode::FP16>(test.a16(lane), test.b16(lane), test.expected16(lane), lane, bins);
+            }
+            break;
+        case TestMode::BF16:
+            for (uint32_t lane = 0; lane < 2; ++lane) {
+                lane_bins<TestMode::BF16>(test.a16(lane), test.b16(lane), test.expected16(lane), lane, bins);
+            }
+            break;
+        // Widen 的16位操作数位于第2路
+        case TestMode::FP16_Widen:
+            lane_bins<TestMode::FP16_Widen>(test.a16(1), test.b16(1), test.expected_bits, 1, bins);
+            break;
+        case TestMode::BF16_Widen:
+            lane_bins<TestMode::BF16_Widen>(test.a16(1), test.b16(1), test.expected_bits, 1, bins);
+            break;
+    }
+}
@@ -0,0 +1,124 @@
+// ===================================================================
+// libFuzzer 入口: 覆盖率引导的 FAdd_16_32 fuzzing
+// ===================================================================
+// 构建: 定义 FUZZ 并使用 -fsanitize=fuzzer 链接 (main 由 libFuzzer 提供)。
+// 同时定义 COVERAGE 并用 verilator --coverage 生成模型时，RTL覆盖率计数器的
+// 增量会作为 libFuzzer 的额外反馈 (extra counters)。
+//
+// 输入格式: 若干个 9 字节的 beat，每个 beat 为
+//   [0]     模式 (对 5 取模: fp32, fp16, bf16, fp16_widen, bf16_widen)
+//   [1..4]  a (小端，32位打包操作数，16位模式下低/高16位为两路)
+//   [5..8]  b
+// 所有 beat 背靠背送入同一个持久的 Vtop，输入之间不复位，与 SoftFloat 参考模型比较。
+#ifdef FUZZ
+
+#include "include/simulator.h"
+#include "include/batch_check.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const size_t kBeatBytes = 9;
+static const size_t kMaxBeats = 64;
+
+static Simulator* sim = nullptr;
+
+#ifdef COVERAGE
+// libFuzzer 在每次执行前清零该段，执行后读取
+static const size_t kNumExtraCounters = 1 << 16;
+__attribute__((used, section("__libfuzzer_extra_counters")))
+static uint8_t extra_counters[kNumExtraCounters];
+static std::vector<uint32_t> coverage_before;
+#endif
+
+// 与随机生成器一致，不产生NaN操作数 (替换为同符号的无穷大)
+static uint32_t no_nan_fp32(uint32_t v) {
+    return ((v & 0x7F800000) == 0x7F800000 && (v & 0x007FFFFF)) ? (v & 0xFF800000) : v;
+}
+static uint16_t no_nan_fp16(uint16_t v) {
+    return ((v & 0x7C00) == 0x7C00 && (v & 0x03FF)) ? (v & 0xFC00) : v;
+}
+static uint16_t no_nan_bf16(uint16_t v) {
+    return ((v & 0x7F80) == 0x7F80 && (v & 0x007F)) ? (v & 0xFF80) : v;
+}
+
+static uint32_t load_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static TestCase decode_beat(const uint8_t* p) {
+    uint32_t a = load_le32(p + 1), b = load_le32(p + 5);
+    ErrorType e = ErrorType::Precise;
+    switch (p[0] % 5) {
+        case 0:
+            return TestCase(FADD_Operands_Hex{no_nan_fp32(a), no_nan_fp32(b)}, e);
+        case 1:
+            return TestCase(FADD_Operands_Hex_16{no_nan_fp16(a), no_nan_fp16(b)},
+                            FADD_Operands_Hex_16{no_nan_fp16(a >> 16), no_nan_fp16(b >> 16)}, e);
+        case 2:
+            return TestCase(FADD_Operands_Hex_BF16{no_nan_bf16(a), no_nan_bf16(b)},
+                            FADD_Operands_Hex_BF16{no_nan_bf16(a >> 16), no_nan_bf16(b >> 16)}, e);
+        case 3:
+            return TestCase(FADD_Operands_FP16_Widen{no_nan_fp16(a >> 16), no_nan_fp16(b >> 16)}, e);
+        default:
+            return TestCase(FADD_Operands_BF16_Widen{no_nan_bf16(a >> 16), no_nan_bf16(b >> 16)}, e);
+    }
+}
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv) {
+    sim = new Simulator(*argc, *argv);
+    sim->reset(2);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    size_t n = size / kBeatBytes;
+    if (n == 0) return 0;
+    if (n > kMaxBeats) n = kMaxBeats;
+
+    std::vector<TestCase> tests;
+    tests.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        tests.push_back(decode_beat(data + i * kBeatBytes));
+    }
+
+#ifdef COVERAGE
+    size_t num_points = 0;
+    const uint32_t* counters = sim->coverage_counters(num_points);
+    coverage_before.assign(counters, counters + num_points);
+#endif
+
+    std::vector<DutOutputs> outputs(n);
+    if (!sim->run_batch(tests.data(), n, outputs.data(), false)) {
+        printf("FUZZ: pipeline protocol error\n");
+        fflush(stdout);
+        abort();
+    }
+
+#ifdef COVERAGE
+    // 本次输入命中的覆盖点 (计数增量饱和到 255)
+    for (size_t i = 0; i < num_points; ++i) {
+        uint32_t delta = counters[i] - coverage_before[i];
+        if (delta) {
+            uint8_t& c = extra_counters[i % kNumExtraCounters];
+            c = (uint8_t)std::min<uint32_t>(255, c + delta);
+        }
+    }
+#endif
+
+    BatchChecker checker;
+    const std::vector<size_t>& mismatches = checker.fast_check(tests.data(), outputs.data(), n);
+    for (size_t k : mismatches) {
+        tests[k].print_details();
+        if (!tests[k].check_result(outputs[k])) {
+            printf("FUZZ: mismatch at beat %zu of %zu\n", k, n);
+            fflush(stdout);
+            abort(); // 让 libFuzzer 保存导致失败的输入
+        }
+    }
+    return 0;
+}
+
+#endif // FUZZ
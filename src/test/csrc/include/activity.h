@@ -0,0 +1,90 @@
+#ifndef __ACTIVITY_H__
+#define __ACTIVITY_H__
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test_case.h"
+
+// ===================================================================
+// 翻转活动统计 (--activity): 用于功耗估计的 SAIF 导出
+// ===================================================================
+// 在每个周期的上升沿之后采样选定的信号，按位统计翻转次数 (TC) 和为 1 的时间 (T1)，
+// 分别累计到 (激励来源, TestMode) 上下文中。激励来源由驱动方设置，例如 corpus、suite、
+// 自适应测试的各随机桶、npy 张量; TestMode 为当前发射的格式 (排空周期计入最后发射的格式)。
+//
+// 每周期的开销与选定信号的字数成正比: 与上一周期的值异或，只有变化的位才更新计数;
+// T1 在位翻转或上下文切换时才结算。
+//
+// 信号名:
+//   io_a_in_32、io_valid_out 等   top 的端口 (默认选择全部端口)
+//   TOP.top.fadd.<信号>          内部信号，需要 verilator --public-flat-rw 生成模型
+//                                并以 -DACTIVITY_SCOPES 编译测试平台
+//
+// 导出: <prefix>.saif 为全部流量，<prefix>.<来源>.<模式>.saif 为每个上下文
+// (SAIF 2.0，时间单位 1ps，按 --activity-period 给出的时钟周期换算)。
+
+struct ActivityOptions {
+    std::string prefix;                 // --activity: 输出文件前缀，空表示不统计
+    std::vector<std::string> signals;   // --activity-signals: 空表示 top 的全部端口
+    double period_ns = 1.0;             // --activity-period: 时钟周期 (ns)
+};
+
+class ActivityMonitor {
+public:
+    // scope 为 SAIF 中的实例路径 (以 '.' 分隔，例如 "top.fadd")，data 指向模型中的信号值
+    // (宽度不超过 32 位时为 1/2/4 字节整数，否则为 32 位字数组，与 Verilator 的表示一致)
+    void add_signal(const std::string& scope, const std::string& name, const void* data, int width);
+
+    void set_source(const std::string& source);
+
+    // 上升沿之后调用一次; issued 为该周期是否发射了操作 (valid_in)
+    void sample(TestMode mode, bool issued);
+
+    bool write(const ActivityOptions& opts);
+    void print_summary() const;
+
+    size_t num_signals() const { return signals_.size(); }
+
+private:
+    struct Signal {
+        std::string scope, name;
+        const uint8_t* data;
+        int width;
+        int bytes;      // 宽度不超过 32 位时的整数字节数
+        size_t word;    // 在 prev_ 中的第一个字
+        size_t bit;     // 在按位计数器中的第一位
+    };
+    struct Context {
+        std::string source;
+        TestMode mode;
+        uint64_t cycles = 0;
+        uint64_t ops = 0;
+        std::vector<uint64_t> toggles;  // 每位的翻转次数
+        std::vector<uint64_t> high;     // 每位为 1 的周期数
+    };
+
+    uint32_t read_word(const Signal& s, size_t k) const;
+    Context& context(TestMode mode);
+    void settle_high(uint64_t end);     // 把各位到周期 end (不含) 为止的高电平时间结算到当前上下文
+    bool write_saif(const std::string& path, const std::vector<const Context*>& contexts, uint64_t period_ps) const;
+
+    std::vector<Signal> signals_;
+    size_t num_words_ = 0;
+    size_t num_bits_ = 0;
+    std::vector<uint32_t> prev_;
+    std::vector<uint64_t> since_;       // 每位最近一次结算的周期
+    bool primed_ = false;
+    uint64_t now_ = 0;
+
+    std::string source_ = "default";
+    std::map<std::pair<std::string, int>, size_t> index_;
+    std::deque<Context> contexts_;      // 只在尾部追加，cur_ 保持有效
+    Context* cur_ = nullptr;
+};
+
+#endif // __ACTIVITY_H__
@@ -0,0 +1,46 @@
+#ifndef __ADAPTIVE_H__
+#define __ADAPTIVE_H__
+
+#include <cstdint>
+#include <vector>
+
+#include "simulator.h"
+#include "options.h"
+#include "failure_corpus.h"
+
+// ===================================================================
+// 自适应随机测试调度 (--adaptive)
+// ===================================================================
+// 定向测试照常全部运行，随机测试不再为每个桶固定生成 num_random_tests 个向量，
+// 而是每轮挑选一个桶生成一批向量:
+//   - 按桶的产出 (新增覆盖箱 + near-miss) 与已运行向量数之比分配，
+//     优先运行仍在产出新覆盖或接近出错的桶;
+//   - 桶内没有失败时，失败率的单侧置信上界 1 - (1 - C)^(1/n) (Clopper-Pearson, 0次失败)
+//     降到 --max-fail-rate 以下、且最近一批没有新增覆盖箱即停止该桶 (覆盖箱有限，
+//     每个桶最终都会停止; near-miss 可以无限重复，只影响分配顺序，不阻止停止);
+//     出现失败的桶也停止并报告。
+//   - --budget 限制随机向量总数 (默认为固定分配的 kAdaptiveBudgetFactor 倍)，
+//     预算用完时按产出排在后面的桶先被截断。
+// near-miss 指结果在允许误差内通过、但与参考结果位模式不同的向量。
+struct BucketStats {
+    const RandomBucket* bucket;
+    uint64_t run = 0;
+    uint64_t failed = 0;
+    uint64_t new_bins = 0;      // 该桶首次命中的功能/RTL覆盖箱
+    uint64_t near_misses = 0;
+    uint64_t last_new_bins = 0; // 最近一批新增的覆盖箱
+    bool done = false;
+};
+
+// 未指定 --budget 时，随机向量预算为固定分配 (每桶 num_random_tests / count_divisor) 的倍数
+const uint64_t kAdaptiveBudgetFactor = 4;
+
+// 0 次失败时达到置信上界所需的向量数
+uint64_t zero_failure_sample_size(double confidence, double max_fail_rate);
+// 0 次失败、n 个向量时失败率的单侧置信上界
+double failure_rate_upper_bound(double confidence, uint64_t n);
+
+// --adaptive 入口，失败的向量加入 corpus (可为空)，返回进程退出码
+int run_adaptive(Simulator& sim, const SimOptions& opts, uint32_t seed, FailureCorpus* corpus = nullptr);
+
+#endif // __ADAPTIVE_H__
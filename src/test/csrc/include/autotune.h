@@ -0,0 +1,41 @@
+#ifndef __AUTOTUNE_H__
+#define __AUTOTUNE_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "test_case.h"
+#include "options.h"
+
+// ===================================================================
+// 线程划分自动调优 (--autotune)
+// ===================================================================
+// 多线程模型 (verilator --threads N) 把一次 eval 拆到 N 个线程上，
+// 另一种用法是运行多个互相独立的单线程实例、每个实例处理一部分向量。
+// 哪种划分更快取决于 DUT 的规模，因此对同一组向量逐个测量:
+//   instances 个独立的 Simulator (各自的 VerilatedContext)，每个使用模型编译时的线程数，
+//   instances 从 1 增加到 cores / 模型线程数。
+// 模型线程数在 Verilate 时确定，比较不同的模型线程数需要每个 --threads 值一个构建，
+// 各构建把结果追加到同一个文件，每次运行结束时对文件中的全部结果排序并给出最佳划分:
+//   ./Vtop_t1 --autotune tune.txt && ./Vtop_t4 --autotune tune.txt
+struct AutotuneResult {
+    unsigned model_threads = 1;
+    unsigned instances = 1;
+    uint64_t ops = 0;
+    double seconds = 0;
+
+    double ops_per_sec() const { return seconds > 0 ? ops / seconds : 0.0; }
+};
+
+// 以 instances 个独立实例并行运行 tests (按连续区间划分)，返回 false 表示仿真超时
+bool benchmark_split(const SimOptions& opts, const std::vector<TestCase>& tests, unsigned instances,
+                     unsigned threads, AutotuneResult& result);
+
+bool read_autotune_file(const std::string& path, std::vector<AutotuneResult>& results);
+bool append_autotune_file(const std::string& path, const std::vector<AutotuneResult>& results);
+
+// --autotune 入口，返回进程退出码
+int run_autotune(const SimOptions& opts);
+
+#endif // __AUTOTUNE_H__
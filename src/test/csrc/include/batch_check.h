@@ -0,0 +1,38 @@
+#ifndef __BATCH_CHECK_H__
+#define __BATCH_CHECK_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "test_case.h"
+
+// ===================================================================
+// BatchChecker: 整批结果的快速检查
+// ===================================================================
+// 快速路径把期望值/DUT输出/允许的ULP误差整理成结构数组 (SoA)，用无分支的
+// 整数比较一次检查整批结果 (编译器可自动向量化)，接受:
+//   位模式完全相同、两者都是零 (忽略符号)、或在该模式允许的ULP误差之内。
+// 其余向量 (通常极少) 才交给 TestCase::check_result 做完整检查和打印，
+// 相对误差等需要浮点计算的判定只在慢路径中进行。
+class BatchChecker {
+public:
+    // 检查一批结果，返回需要走慢路径的测试在批次内的下标 (升序)
+    const std::vector<size_t>& fast_check(const TestCase* tests, const DutOutputs* outputs, size_t n);
+
+    uint64_t checked() const { return checked_; }
+    uint64_t slow_path() const { return slow_path_; }
+
+private:
+    std::vector<uint32_t> expected_;
+    std::vector<uint32_t> got_;
+    std::vector<uint32_t> ulp_limit_;
+    std::vector<uint32_t> dual_;     // FP16/BF16 双路结果: 全1，否则为0
+    std::vector<uint32_t> fast_mask_; // 该组合有判定规则: 全1，否则为0 (总是走慢路径)
+    std::vector<uint8_t> ok_;
+    std::vector<size_t> mismatches_;
+    uint64_t checked_ = 0;
+    uint64_t slow_path_ = 0;
+};
+
+#endif // __BATCH_CHECK_H__
@@ -0,0 +1,34 @@
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include <cstdint>
+
+// ===================================================================
+// 断点续跑 (checkpoint) 时保存的测试平台状态
+// ===================================================================
+// 测试向量全部由 seed 确定地生成，因此 (seed, next_test) 即可还原
+// 生成器位置，无需保存 rand() 的内部状态。
+// 检查点只在两个测试之间写入，此时DUT中没有未完成的事务。
+// 文件中紧跟 HarnessState 保存 failed 个失败测试的序号 (uint64_t)。
+// 分片、模式、--count 和测试序列摘要标识写入检查点的 campaign，
+// 续跑时与本次运行的选项不一致则拒绝恢复，避免把两个 campaign 的结果混在一起。
+struct HarnessState {
+    uint32_t seed;       // 随机数种子
+    uint32_t reserved;
+    uint64_t next_test;  // 下一个待执行测试的序号
+    uint64_t passed;     // 已通过的测试数
+    uint64_t failed;     // 已失败的测试数
+    uint64_t sim_time;   // VerilatedContext 仿真时间
+    uint32_t shard_index;
+    uint32_t shard_count;
+    int32_t num_random_tests; // --count
+    uint32_t reserved2;
+    uint64_t suite_digest;    // suite_digest() 计算的测试序列摘要
+    char modes[64];           // selection_modes() 或 "pack"，以 '\0' 结尾
+};
+
+// 检查点文件头: 魔数 + 版本号，用于在不同机器间恢复时校验
+const uint32_t kCheckpointMagic = 0x56465055; // "VFPU"
+const uint32_t kCheckpointVersion = 3;
+
+#endif // __CHECKPOINT_H__
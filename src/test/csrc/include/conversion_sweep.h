@@ -0,0 +1,38 @@
+#ifndef __CONVERSION_SWEEP_H__
+#define __CONVERSION_SWEEP_H__
+
+#include <cstdint>
+#include <vector>
+
+// ===================================================================
+// fp_utils 转换函数的穷举验证 (--conversion-sweep)
+// ===================================================================
+// 参考结果与覆盖范围:
+//   fp16_to_fp32  全部 2^16 个输入，对比 SoftFloat f16_to_f32
+//   bf16_to_fp32  全部 2^16 个输入，对比按数值构造的 FP32 (bf16 是 FP32 的高16位)
+//   fp32_to_fp16  全部 2^32 个输入，对比 SoftFloat f32_to_f16 (RNE)
+//   fp32_to_bf16  全部 2^32 个输入，对比独立实现的 RNE 参考: 用 double 比较
+//                 向零截断的候选值与下一个值到输入的距离，距离相等时取偶数
+// NaN 的载荷与 quiet 位由实现决定，两边都是 NaN 且符号相同即视为一致。
+// 2^32 的扫描按块分给多个线程 (--sweep-threads)，--sweep-step N 只测试每 N 个输入中的一个。
+// SoftFloat 的参考结果经 softfloat_ref 分批计算; 以 -DSOFTFLOAT_TLS 构建时各线程互不加锁。
+struct ConversionMismatch {
+    uint32_t input;
+    uint32_t got;
+    uint32_t expected;
+};
+
+struct ConversionResult {
+    const char* name;
+    uint64_t tested = 0;
+    uint64_t mismatches = 0;
+    std::vector<ConversionMismatch> first;  // 输入最小的若干个不一致
+};
+
+// FP32 -> BF16 的 RNE 参考实现
+uint16_t reference_fp32_to_bf16(uint32_t bits);
+
+// 运行全部扫描并打印报告，threads 为 0 时使用全部核。返回进程退出码
+int run_conversion_sweep(unsigned threads, uint64_t step);
+
+#endif // __CONVERSION_SWEEP_H__
@@ -0,0 +1,30 @@
+#ifndef __COVERAGE_DB_H__
+#define __COVERAGE_DB_H__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// Verilator 覆盖率数据库 (coverage.dat) 的读取、合并与报告
+// ===================================================================
+// 每个覆盖点一行: C '<\001key\002value...>' count
+// 常用的 key: page (例如 v_line/FAdd_16_32, v_toggle/ShiftRightJam)、
+// f (源文件)、l (行号)、o (注释/信号名)、h (实例层次)。
+// 覆盖点以完整的 key 串标识，合并时相同覆盖点的计数相加 (与 verilator_coverage 一致)。
+typedef std::map<std::string, uint64_t> CoverageDb;
+
+// 读取一个 coverage.dat 并累加到 db 中
+bool read_coverage_file(const std::string& path, CoverageDb& db);
+bool write_coverage_file(const std::string& path, const CoverageDb& db);
+
+// 按模块和覆盖类型 (line/toggle/branch...) 统计，并列出未覆盖的行与信号
+// max_list 为每个模块每种类型最多列出的未覆盖点数，0 表示全部列出
+void print_coverage_report(const CoverageDb& db, size_t max_list = 20);
+
+// --coverage-merge 入口: 合并各分片的覆盖率并打印报告，output_path 非空时写出合并结果
+// 返回进程退出码
+int merge_coverage_files(const std::vector<std::string>& inputs, const std::string& output_path);
+
+#endif // __COVERAGE_DB_H__
@@ -0,0 +1,55 @@
+#ifndef __FAILURE_CORPUS_H__
+#define __FAILURE_CORPUS_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "test_case.h"
+
+class Simulator;
+struct SimOptions;
+
+// ===================================================================
+// 失败语料库 (failure corpus): 跨运行保存出错的向量
+// ===================================================================
+// 每个失败的向量按 (模式, 操作数) 去重后追加到语料库文件 (默认 failure_corpus.txt)，
+// 每次运行在任何随机测试之前先以流水线方式回放整个语料库，已知的错误角落
+// 在每次 RTL 修改后都能在毫秒级内重新检查。
+// 文件为逐行文本，每行一个向量:
+//   <mode> <a_bits> <b_bits> <error_type>
+// 例如 "bf16 3f80c000 bf800001 ulp"。操作数按 TestCase 的打包方式 (十六进制)，
+// Widen 模式的低16位不属于操作数，记录前清零。'#' 开头的行为注释。
+// 追加时每个向量一次写入，多个分片可以同时追加同一个文件; 读入时再去重。
+class FailureCorpus {
+public:
+    ~FailureCorpus();
+
+    // 读入语料库，文件不存在视为空语料库
+    bool load(const std::string& path);
+
+    // 追加一个失败的向量，已在语料库中时忽略; 返回是否为新向量
+    bool add(const TestCase& test);
+
+    const std::vector<TestCase>& tests() const { return tests_; }
+    uint64_t added() const { return added_; }
+    const std::string& path() const { return path_; }
+
+private:
+    bool insert(const TestCase& test);
+
+    std::string path_;
+    std::vector<TestCase> tests_;
+    std::set<std::tuple<TestMode, uint32_t, uint32_t>> keys_;
+    FILE* append_ = nullptr;
+    uint64_t added_ = 0;
+};
+
+// 以流水线方式回放语料库中本分片的向量 (第 k 个向量属于 k % shard_count 分片)，
+// 返回失败的向量数，超时返回 -1
+int64_t replay_corpus(Simulator& sim, const FailureCorpus& corpus, const SimOptions& opts);
+
+#endif // __FAILURE_CORPUS_H__
@@ -0,0 +1,108 @@
+#ifndef __FORMAT_TRAITS_H__
+#define __FORMAT_TRAITS_H__
+
+#include <cstdint>
+#include <cstring>
+
+#include "fp_utils.h"
+#include "test_case.h"
+
+// ===================================================================
+// 格式特征 (format traits): 每种浮点格式的位宽与允许误差
+// ===================================================================
+// 阈值使用 double 常量，与原先 std::pow(2, -n) / 1e-3 等写法的比较结果一致。
+
+// FP32 单精度结果
+struct Fp32Format {
+    typedef uint32_t bits_t;
+    static constexpr uint32_t abs_mask = 0x7FFFFFFF;
+    static constexpr int exp_bits = 8, man_bits = 23;
+    static constexpr int ulp_limit = 8;
+    static constexpr double rel_small_abs = 1.0 / (1ull << 60); // 操作数绝对值小于该值时放宽相对误差
+    static constexpr double rel_small_limit = 1e-3;
+    static constexpr double rel_limit = 1e-5;
+    static constexpr const char* rel_limit_text = "1e-5";
+    static float to_fp32(uint32_t bits) {
+        float f;
+        memcpy(&f, &bits, sizeof(float));
+        return f;
+    }
+};
+
+// Widen (FP16/BF16 -> FP32) 结果
+struct WidenFp32Format : Fp32Format {
+    static constexpr int ulp_limit = 2;
+};
+
+// FP16 半精度
+struct Fp16Format {
+    typedef uint16_t bits_t;
+    static constexpr uint16_t abs_mask = 0x7FFF;
+    static constexpr int exp_bits = 5, man_bits = 10;
+    static constexpr int ulp_limit = 5;
+    static constexpr double rel_small_abs = 1.0 / (1ull << 10); // FP16精度较低，调整阈值
+    static constexpr double rel_small_limit = 1e-2;
+    static constexpr double rel_limit = 1e-3;         // FP16相对误差要求比FP32宽松
+    static constexpr const char* rel_limit_text = "1e-3";
+    static float to_fp32(uint16_t bits) { return fp16_to_fp32(bits); }
+};
+
+// BF16
+struct Bf16Format {
+    typedef uint16_t bits_t;
+    static constexpr uint16_t abs_mask = 0x7FFF;
+    static constexpr int exp_bits = 8, man_bits = 7;
+    static constexpr int ulp_limit = 2;
+    static constexpr double rel_small_abs = 1.0 / (1ull << 30); // BF16有较好的指数范围，但尾数精度较低
+    static constexpr double rel_small_limit = 1e-2;
+    static constexpr double rel_limit = 8e-3;         // BF16相对误差要求介于FP32和FP16之间
+    static constexpr const char* rel_limit_text = "8e-3";
+    static float to_fp32(uint16_t bits) { return bf16_to_fp32(bits); }
+};
+
+// ===================================================================
+// 模式特征 (mode traits): 每种 TestMode 的控制信号与输入/结果格式
+// ===================================================================
+template <TestMode M> struct ModeTraits;
+
+template <> struct ModeTraits<TestMode::FP32> {
+    static constexpr bool is_fp32 = true, is_fp16 = false, is_bf16 = false, is_widen = false;
+    typedef Fp32Format in_format;
+    typedef Fp32Format res_format;
+};
+
+template <> struct ModeTraits<TestMode::FP16> {
+    static constexpr bool is_fp32 = false, is_fp16 = true, is_bf16 = false, is_widen = false;
+    typedef Fp16Format in_format;
+    typedef Fp16Format res_format;
+};
+
+template <> struct ModeTraits<TestMode::BF16> {
+    static constexpr bool is_fp32 = false, is_fp16 = false, is_bf16 = true, is_widen = false;
+    typedef Bf16Format in_format;
+    typedef Bf16Format res_format;
+};
+
+template <> struct ModeTraits<TestMode::FP16_Widen> {
+    static constexpr bool is_fp32 = false, is_fp16 = true, is_bf16 = false, is_widen = true;
+    typedef Fp16Format in_format;
+    typedef WidenFp32Format res_format;
+};
+
+template <> struct ModeTraits<TestMode::BF16_Widen> {
+    static constexpr bool is_fp32 = false, is_fp16 = false, is_bf16 = true, is_widen = true;
+    typedef Bf16Format in_format;
+    typedef WidenFp32Format res_format;
+};
+
+const int kNumTestModes = 5;
+const int kNumErrorTypes = 4;
+
+// FP32 与 FP16 双路结果没有 ULP_or_RelativeError 判定规则，这类用例总是判为不通过;
+// BF16 按 ulp 或相对误差判定，Widen 模式除 Precise 外均按 ULP 判定
+template <TestMode M>
+constexpr bool has_check_rule(ErrorType e) {
+    return e != ErrorType::ULP_or_RelativeError || ModeTraits<M>::is_bf16 || ModeTraits<M>::is_widen;
+}
+
+#endif // __FORMAT_TRAITS_H__
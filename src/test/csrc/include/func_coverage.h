@@ -0,0 +1,32 @@
+#ifndef __FUNC_COVERAGE_H__
+#define __FUNC_COVERAGE_H__
+
+#include <cstdint>
+#include <vector>
+
+#include "test_case.h"
+
+// ===================================================================
+// 功能覆盖率 (functional coverage) 分箱
+// ===================================================================
+// 每个测试向量按模式和每一路 (lane) 计算若干个覆盖箱 (bin)，每个箱是一个32位编号:
+//   [26:24] TestMode  [20] lane  [19:16] 特征  [15:0] 特征取值
+// 特征:
+//   Class   两个操作数的类别组合 (零/非规格化/规格化/无穷/NaN)
+//   Align   有效加/减 x 对阶移位量 (对数分桶) x 是否整体移出到 sticky 位
+//   Result  结果类别 x 符号
+//   Norm    有效加减后规格化移位量 (进位/不移/对数分桶)
+//   Round   结果是否不精确 (需要舍入)
+// 最高位 (bit 31) 保留给 RTL 覆盖点，见 suite_min.cpp。
+enum class CoverageFeature : uint32_t {
+    Class = 1,
+    Align = 2,
+    Result = 3,
+    Norm = 4,
+    Round = 5,
+};
+
+// 把 test 命中的功能覆盖箱追加到 bins 中
+void functional_bins(const TestCase& test, std::vector<uint32_t>& bins);
+
+#endif // __FUNC_COVERAGE_H__
@@ -0,0 +1,63 @@
+#ifndef __ISSUE_PATTERN_H__
+#define __ISSUE_PATTERN_H__
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+// ===================================================================
+// IssuePattern: 流水线批量执行时 io_valid_in 的发射模式
+// ===================================================================
+//   full              每周期发射一个操作
+//   bernoulli:P       每周期以概率 P 发射
+//   burst:N:G         连续发射 N 个，然后空闲 G 个周期
+//   periodic:K        每 K 个周期插入一个空泡 (bubble)
+enum class IssueKind {
+    Full,
+    Bernoulli,
+    Burst,
+    Periodic
+};
+
+struct IssuePattern {
+    IssueKind kind = IssueKind::Full;
+    double probability = 1.0;  // Bernoulli
+    unsigned burst = 1;        // Burst: 每次连续发射的个数
+    unsigned gap = 0;          // Burst: 两次突发之间的空闲周期
+    unsigned period = 0;       // Periodic: 空泡间隔
+};
+
+// 解析 "full" / "bernoulli:0.7" / "burst:8:3" / "periodic:4"
+bool parse_issue_pattern(const char* text, IssuePattern& pattern);
+const char* issue_kind_name(IssueKind kind);
+// 完整的发射模式文本 (含参数)，parse_issue_pattern 可以解析回同一模式
+std::string issue_pattern_text(const IssuePattern& pattern);
+
+// 按发射模式逐周期决定是否发射
+class IssueGenerator {
+public:
+    explicit IssueGenerator(const IssuePattern& pattern) : pattern_(pattern) {}
+
+    // 本周期是否拉高 valid_in
+    bool next() {
+        switch (pattern_.kind) {
+            case IssueKind::Full:
+                return true;
+            case IssueKind::Bernoulli:
+                return rand() < pattern_.probability * ((double)RAND_MAX + 1.0);
+            case IssueKind::Burst: {
+                unsigned pos = counter_++ % (pattern_.burst + pattern_.gap);
+                return pos < pattern_.burst;
+            }
+            case IssueKind::Periodic:
+                return ++counter_ % pattern_.period != 0;
+        }
+        return true;
+    }
+
+private:
+    IssuePattern pattern_;
+    uint64_t counter_ = 0;
+};
+
+#endif // __ISSUE_PATTERN_H__
@@ -0,0 +1,44 @@
+#ifndef __NPY_FILE_H__
+#define __NPY_FILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// 只读内存映射的 .npy 数组
+// ===================================================================
+// 支持 NPY 格式 1.0/2.0/3.0 中 C 顺序 (fortran_order: False)、小端、
+// 2字节或4字节元素的数组，数据区直接映射，不复制。
+// numpy 没有原生的 bfloat16，ml_dtypes 保存的 bfloat16 数组的 descr 为 "<V2"。
+class NpyArray {
+public:
+    NpyArray() = default;
+    ~NpyArray();
+
+    NpyArray(const NpyArray&) = delete;
+    NpyArray& operator=(const NpyArray&) = delete;
+
+    // 出错时打印原因并返回 false
+    bool open(const std::string& path);
+
+    const void* data() const { return data_; }
+    size_t count() const { return count_; }
+    size_t item_size() const { return item_size_; }
+    const std::string& descr() const { return descr_; }
+    const std::vector<size_t>& shape() const { return shape_; }
+    // 最后一维的长度 (0维数组为1)，归约按此分行
+    size_t row_length() const { return shape_.empty() ? 1 : shape_.back(); }
+
+private:
+    void* map_ = nullptr;
+    size_t map_size_ = 0;
+    const uint8_t* data_ = nullptr;
+    size_t count_ = 0;
+    size_t item_size_ = 0;
+    std::string descr_;
+    std::vector<size_t> shape_;
+};
+
+#endif // __NPY_FILE_H__
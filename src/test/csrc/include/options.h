@@ -0,0 +1,94 @@
+#ifndef __OPTIONS_H__
+#define __OPTIONS_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "test_factory.h"
+#include "issue_pattern.h"
+#include "wave_trace.h"
+#include "activity.h"
+
+// ===================================================================
+// SimOptions: 测试平台命令行参数
+// ===================================================================
+// 未识别的参数 (例如 +verilator+seed+1) 原样转发给 VerilatedContext。
+struct SimOptions {
+    TestSelection selection;         // --modes, --count
+
+    uint32_t seed = 0;               // --seed，未指定时使用 time(NULL)
+    bool seed_set = false;
+
+    unsigned shard_index = 0;        // --shard i/N: 只运行序号 % N == i 的测试
+    unsigned shard_count = 1;
+
+    uint64_t max_failures = 1;       // --max-failures，0 表示不限制
+
+    unsigned sequences = 0;          // --sequences: 用 N 个并发协程序列运行测试 (C++20 构建)
+    unsigned sequence_window = 4;    // --sequence-window: 每个序列最多的未完成事务数
+
+    bool stream = false;             // --stream: 以流水线方式每周期发射一个测试
+    uint64_t batch_size = 4096;      // --batch-size: 流水线批次大小
+    IssuePattern issue;              // --issue: 流水线发射模式
+    uint64_t latency = 0;            // --latency: 期望的流水线延迟，0 表示自动测量
+
+    unsigned threads = 0;            // --threads: VerilatedContext 线程数，0 表示 Verilator 默认值
+    bool autotune = false;           // --autotune [FILE]: 测量多线程模型与多个独立实例的吞吐量
+    std::string autotune_path;       //   结果追加到 FILE，跨构建比较
+    uint64_t autotune_ops = 200000;  // --autotune-ops: 每种划分运行的向量数
+    unsigned autotune_cores = 0;     // --autotune-cores: 可用核数，0 表示 hardware_concurrency
+
+    std::string serve_path;          // --serve: 作为常驻服务监听的 Unix socket
+    unsigned serve_instances = 1;    // --serve-instances: 常驻的 Vtop 实例数
+
+    std::vector<std::string> npy_inputs; // --npy-add A B / --npy-sum A: 真实张量的数值仿真
+    std::string npy_format;          // --npy-format: fp32/fp16/bf16，默认由 dtype 推断
+    bool npy_widen = false;          // --npy-widen: 16位输入使用 Widen 模式，FP32 结果/累加
+
+    bool conversion_sweep = false;   // --conversion-sweep: 穷举验证 fp_utils 的格式转换后退出
+    unsigned sweep_threads = 0;      // --sweep-threads: 0 表示全部核
+    uint64_t sweep_step = 1;         // --sweep-step: 每 N 个 FP32 输入测试一个
+
+    bool adaptive = false;           // --adaptive: 按产出分配随机向量，按置信上界停止
+    double confidence = 0.95;        // --confidence
+    double max_fail_rate = 0.02;     // --max-fail-rate: 每个桶要证明的失败率上界
+    uint64_t budget = 0;             // --budget: 随机向量总数上限，0 表示固定分配的 kAdaptiveBudgetFactor 倍
+
+    std::string signature_path;        // --signature: 与签名文件比较，不计算参考结果
+    std::string record_signature_path; // --record-signature: 记录本分片的输出签名
+    uint64_t signature_block = 4096;   // --signature-block: 前缀哈希间隔
+
+    std::string result_path;         // --result: 本分片的结果文件
+    std::string checkpoint_path;     // --checkpoint
+    uint64_t checkpoint_every = 1000; // --checkpoint-every
+    std::string restore_path;        // --restore
+
+    std::string pack_path;           // --pack: 回放向量包，代替生成的测试集
+    std::string record_stimulus_path; // --record-stimulus: 逐周期记录驱动的输入
+    std::string replay_stimulus_path; // --replay-stimulus: 回放记录的输入后退出
+    std::string corpus_path = "failure_corpus.txt"; // --corpus: 失败语料库，启动时回放; --no-corpus 关闭
+    std::string minimize_path;       // --minimize: 精简测试集并写出向量包后退出
+
+    std::vector<std::string> merge_inputs; // --merge f1 f2 ...: 合并分片结果后退出
+
+    std::string coverage_path;       // --coverage: 覆盖率数据库 (COVERAGE 编译时)
+    std::vector<std::string> coverage_inputs; // --coverage-merge f1 f2 ...: 合并覆盖率并报告后退出
+
+    std::string trace_path;          // --trace: 性能跟踪输出 (PERF_TRACE 编译时)
+    WaveOptions wave;                // --wave*: 波形跟踪 (VCD/FST 编译时)
+    ActivityOptions activity;        // --activity*: 翻转活动统计与 SAIF 导出
+    bool profile_eval = false;       // --profile-eval: 按模式统计 Vtop::eval() 耗时
+    std::vector<std::string> prof_inputs; // --prof-report [mode=]f1 ...: 按 RTL 模块汇总 gprof 报告后退出
+
+    bool show_help = false;
+
+    // 转发给 Verilator 的参数 (argv[0] + 未识别参数)
+    std::vector<char*> verilator_args;
+};
+
+// 解析命令行，出错时打印原因并返回 false
+bool parse_options(int argc, char* argv[], SimOptions& opts);
+void print_usage(const char* prog);
+
+#endif // __OPTIONS_H__
@@ -0,0 +1,57 @@
+#ifndef __PERF_TRACE_H__
+#define __PERF_TRACE_H__
+
+#include <string>
+
+// ===================================================================
+// 性能跟踪: RAII 作用域计时器，导出为 Chrome trace-event JSON
+// ===================================================================
+// 只在定义 PERF_TRACE 时编译，否则 TRACE_SCOPE 为空语句、没有任何开销。
+// 每个线程一个固定容量的环形缓冲区，写满后覆盖最早的事件，记录时无锁。
+// 导出的文件可直接用 Perfetto (ui.perfetto.dev) 或 chrome://tracing 打开。
+//
+//   void Simulator::run_batch(...) {
+//       TRACE_SCOPE("run_batch");
+//       ...
+//   }
+//
+// 每周期或每个向量执行一次的作用域 (Vtop::eval、参考计算等) 用 TRACE_HOT_SCOPE:
+// 不进入环形缓冲区，只按名称累计次数、总耗时和最大耗时，导出时打印汇总并写入
+// JSON 的 otherData，避免长时间运行时把阶段事件挤出缓冲区。
+
+#ifdef PERF_TRACE
+
+#include <cstdint>
+
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char* name, bool hot = false);
+    ~ScopedTrace();
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    const char* name_; // 必须是字符串常量
+    bool hot_;
+    uint64_t begin_ns_;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) ScopedTrace TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_HOT_SCOPE(name) ScopedTrace TRACE_CONCAT(trace_scope_, __LINE__)(name, true)
+
+// 进程退出时把所有线程的事件写入 path
+void set_trace_output(const std::string& path);
+// 停止记录并等待各线程正在进行的写入结束后导出; 之后的作用域不再记录
+bool write_chrome_trace(const std::string& path);
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_HOT_SCOPE(name) ((void)0)
+
+#endif // PERF_TRACE
+
+#endif // __PERF_TRACE_H__
@@ -0,0 +1,46 @@
+#ifndef __RESULT_FILE_H__
+#define __RESULT_FILE_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "test_case.h"
+
+// 单个失败测试的记录: 全局测试序号 + 模式
+// (测试向量由 seed 确定地生成，序号即可复现该向量)
+struct FailureRecord {
+    uint64_t index;
+    TestMode mode;
+};
+
+// ===================================================================
+// ShardResult: 一个分片 (或合并后的整个campaign) 的运行结果
+// ===================================================================
+struct ShardResult {
+    uint32_t seed = 0;
+    unsigned shard_index = 0;
+    unsigned shard_count = 1;
+    bool merged = false;        // 由 --merge 合并得到
+    std::string modes;          // 运行的模式列表，例如 "fp32,bf16"
+    int num_random_tests = 0;   // 每个随机bucket的向量数
+    uint64_t total = 0;         // 本分片应运行的测试数
+    uint64_t run = 0;           // 实际运行的测试数 (达到失败预算时提前停止)
+    uint64_t passed = 0;
+    uint64_t failed = 0;
+    std::vector<FailureRecord> failures;
+};
+
+// 结果文件为逐行 "key value" 的文本格式，便于合并与人工查看
+bool write_result_file(const std::string& path, const ShardResult& r);
+bool read_result_file(const std::string& path, ShardResult& r);
+
+// 合并多个分片结果，seed/分片数/模式不一致时返回 false
+bool merge_results(const std::vector<ShardResult>& shards, ShardResult& merged);
+void print_result_report(const ShardResult& r);
+
+// --merge 入口: 读取、合并并打印报告，output_path 非空时写出合并结果
+// 返回进程退出码
+int merge_result_files(const std::vector<std::string>& inputs, const std::string& output_path);
+
+#endif // __RESULT_FILE_H__
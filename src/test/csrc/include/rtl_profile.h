@@ -0,0 +1,39 @@
+#ifndef __RTL_PROFILE_H__
+#define __RTL_PROFILE_H__
+
+#include <string>
+#include <vector>
+
+#include "simulator.h"
+
+// ===================================================================
+// RTL 热点分析: 把仿真时间归到 RTL 模块和 TestMode
+// ===================================================================
+// 两个层次:
+//   1. --profile-eval: 任何构建都可用，测量每次 Vtop::eval() 的耗时，按当前模式汇总。
+//   2. --prof-report: 读取 verilator --prof-cfuncs 构建 (同时用 -pg 编译链接) 产生的
+//      gprof 平面报告。--prof-cfuncs 生成的函数名带有 __PROF__<模块>__l<行号> 后缀，
+//      据此把 self time 归到模块与源代码行; 其余 Vtop 函数归入 "(Vtop other)"，
+//      测试平台自身的函数归入 "(harness)"。
+// 按模式归因需要每种模式单独运行一次并生成报告:
+//   ./Vtop --modes fp16 --count 20000 && gprof Vtop gmon.out > fp16.txt
+//   ./Vtop --prof-report fp32=fp32.txt fp16=fp16.txt bf16=bf16.txt
+// verilator --prof-exec 构建的 +verilator+prof+exec+* 参数原样转发给 Verilator，
+// 生成的 profile_exec.dat 用 verilator_gantt 查看。
+struct RtlProfileEntry {
+    std::string module;   // RTL 模块名，或 "(Vtop other)" / "(harness)"
+    int line;             // RTL 源代码行号，未知时为 0
+    double self_seconds;
+    std::string function;
+};
+
+// 读取一个 gprof 平面报告 (gprof -p 或默认输出的 "Flat profile" 部分)
+bool read_gprof_flat(const std::string& path, std::vector<RtlProfileEntry>& entries);
+
+// 打印 --profile-eval 汇总表
+void print_eval_profile(const EvalProfile& prof);
+
+// --prof-report 入口: inputs 为 "[label=]FILE"，label 通常是模式名。返回进程退出码
+int rtl_profile_report(const std::vector<std::string>& inputs, size_t max_lines = 10);
+
+#endif // __RTL_PROFILE_H__
@@ -0,0 +1,174 @@
+#ifndef __SEQUENCE_H__
+#define __SEQUENCE_H__
+
+#include <cstdint>
+#include <vector>
+
+#include "test_case.h"
+
+class Simulator;
+
+// ===================================================================
+// 基于 C++20 协程的事务序列 (sequence)
+// ===================================================================
+// 每个激励序列写成一个返回 Sequence 的协程，由 SeqScheduler 在同一个时钟循环上
+// 复用执行，成千上万个并发序列也不需要操作系统线程:
+//
+//   Sequence seq(SeqScheduler& s, const TestCase& t) {
+//       co_await s.posedge();                  // 等待下一个时钟沿
+//       Txn id = co_await s.issue(t);          // 等到发射口空闲并被DUT采样
+//       DutOutputs out = co_await s.result(id); // 等到该事务的结果
+//   }
+//   SeqScheduler sched(sim);
+//   sched.spawn(seq(sched, t));
+//   sched.run();
+//
+// 一个序列可以连续 issue 多次再等待结果 (流水线)，也可以 co_await 另一个 Sequence
+// 作为子序列。每个周期最多发射一个事务，多个序列同时请求时按请求顺序仲裁。
+// DUT 按发射顺序返回结果，调度器据此把 valid_out 对应到事务。
+// 需要编译器支持 C++20 协程 (-std=c++20)，否则本头文件不提供任何声明。
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <unordered_map>
+#include <unordered_set>
+
+typedef uint64_t Txn; // 事务编号，按发射顺序递增
+
+class SeqScheduler;
+
+class Sequence {
+public:
+    struct promise_type {
+        SeqScheduler* sched = nullptr;          // 顶层序列: 结束时通知调度器
+        std::coroutine_handle<> continuation;   // 子序列: 结束时恢复父序列
+        std::exception_ptr exception;
+
+        Sequence get_return_object() {
+            return Sequence(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept;
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+    typedef std::coroutine_handle<promise_type> Handle;
+
+    Sequence(Sequence&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    Sequence(const Sequence&) = delete;
+    Sequence& operator=(const Sequence&) = delete;
+    ~Sequence() {
+        if (handle_) handle_.destroy();
+    }
+
+    // co_await 子序列: 立即开始执行，结束后恢复当前序列
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept {
+        handle_.promise().continuation = parent;
+        return handle_;
+    }
+    void await_resume() {
+        if (handle_.promise().exception) std::rethrow_exception(handle_.promise().exception);
+    }
+
+private:
+    friend class SeqScheduler;
+    explicit Sequence(Handle h) : handle_(h) {}
+    Handle release() {
+        Handle h = handle_;
+        handle_ = nullptr;
+        return h;
+    }
+
+    Handle handle_;
+};
+
+class SeqScheduler {
+public:
+    explicit SeqScheduler(Simulator& sim) : sim_(sim) {}
+    ~SeqScheduler();
+
+    // 加入一个顶层序列，在下一次 run 时开始执行
+    void spawn(Sequence seq);
+
+    // 推进时钟直到所有顶层序列结束。结果超时 (timeout 个周期没有 valid_out)、
+    // 多出的 valid_out 或等待从未发射的事务时返回 false。序列抛出的异常在这里重新抛出
+    bool run(uint64_t timeout = 100);
+
+    uint64_t cycle() const { return cycle_; }
+    uint64_t issued() const { return next_txn_; }
+
+    // --- 等待体 ---
+    struct PosedgeAwaiter {
+        SeqScheduler& sched;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { sched.posedge_waiters_.push_back(h); }
+        void await_resume() const noexcept {}
+    };
+
+    struct IssueAwaiter {
+        SeqScheduler& sched;
+        TestCase test;
+        Txn txn = 0;
+        std::coroutine_handle<> handle = {};
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            handle = h;
+            sched.issue_queue_.push_back(this);
+        }
+        Txn await_resume() const noexcept { return txn; }
+    };
+
+    struct ResultAwaiter {
+        SeqScheduler& sched;
+        Txn txn;
+        DutOutputs out = {};
+        std::coroutine_handle<> handle = {};
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> h) {
+            handle = h;
+            sched.result_waiters_[txn] = this;
+        }
+        DutOutputs await_resume() const noexcept { return out; }
+    };
+
+    PosedgeAwaiter posedge() { return PosedgeAwaiter{*this}; }
+    IssueAwaiter issue(const TestCase& test) { return IssueAwaiter{*this, test}; }
+    ResultAwaiter result(Txn txn) { return ResultAwaiter{*this, txn}; }
+
+private:
+    friend struct Sequence::promise_type::FinalAwaiter;
+
+    Simulator& sim_;
+    uint64_t cycle_ = 0;
+    Txn next_txn_ = 0;
+    size_t live_ = 0;                                    // 未结束的顶层序列
+    std::vector<std::coroutine_handle<>> ready_;         // 本周期要恢复的序列
+    std::vector<std::coroutine_handle<>> posedge_waiters_;
+    std::deque<IssueAwaiter*> issue_queue_;
+    std::deque<Txn> in_flight_;                          // 已发射、未返回结果的事务
+    std::unordered_map<Txn, DutOutputs> results_;        // 已返回、尚未被取走的结果
+    std::unordered_map<Txn, ResultAwaiter*> result_waiters_;
+    std::unordered_set<void*> roots_;                    // 调度器拥有的顶层序列帧
+    std::vector<Sequence::Handle> finished_;             // 本周期结束的顶层序列
+};
+
+#endif // __cpp_impl_coroutine
+
+// --sequences 入口: 把 tests[order[k]] 分给 n 个并发序列，每个序列最多保持 window 个未完成事务，
+// 结果返回时检查。失败的测试序号 (tests 中的下标) 按检出顺序写入 failed，通过数写入 passed;
+// 失败数达到 max_failures (0 表示不限制) 后不再发射，已发射事务的结果不再计入。
+// 仿真协议错误时返回 false
+bool run_sequences(Simulator& sim, const std::vector<TestCase>& tests, const std::vector<size_t>& order,
+                   unsigned n, unsigned window, uint64_t max_failures, std::vector<size_t>& failed,
+                   uint64_t& passed);
+
+#endif // __SEQUENCE_H__
@@ -0,0 +1,62 @@
+#ifndef __SIGNATURE_H__
+#define __SIGNATURE_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "test_case.h"
+#include "format_traits.h"
+
+class Simulator;
+struct SimOptions;
+
+// ===================================================================
+// 输出签名 (output signature): 逐位比较的快速回归
+// ===================================================================
+// 本分片按执行顺序把每个DUT输出 (按 expected_bits 的方式打包) 折叠进滚动哈希，
+// 每种模式一个哈希，另有一个覆盖全部输出的哈希。每 block 个输出记录一次前缀哈希，
+// 签名不一致时据此二分定位到第一个不一致的块，再只对该块计算参考结果进行检查。
+// 每次运行前重新设置发射状态与 rand() 种子，检查时从头重放到该块，
+// 使该块以与第一次运行相同的流水线状态执行。
+struct OutputSignature {
+    // 与结果文件相同的 campaign 信息，用于校验两次运行的向量一致
+    uint32_t seed = 0;
+    unsigned shard_index = 0;
+    unsigned shard_count = 1;
+    std::string modes;
+    int num_random_tests = 0;
+    uint64_t batch_size = 0;                // 流水线批次大小，批次之间复位DUT
+    std::string issue = "full";             // 发射模式 (issue_pattern_text)
+
+    uint64_t tests = 0;                     // 本分片的输出个数
+    uint64_t block = 4096;                  // 前缀哈希间隔
+    uint64_t mode_count[kNumTestModes] = {};
+    uint64_t mode_hash[kNumTestModes] = {};
+    uint64_t hash = 0;
+    std::vector<uint64_t> prefix;           // prefix[k]: 前 (k + 1) * block 个输出的哈希
+};
+
+// 滚动哈希
+class SignatureHasher {
+public:
+    explicit SignatureHasher(OutputSignature& sig);
+    void add(TestMode mode, uint32_t beat);
+
+private:
+    static uint64_t fold(uint64_t h, uint32_t beat) {
+        h = (h ^ beat) * 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 29);
+    }
+    OutputSignature& sig_;
+};
+
+bool write_signature_file(const std::string& path, const OutputSignature& sig);
+bool read_signature_file(const std::string& path, OutputSignature& sig);
+
+// --record-signature / --signature 入口: 以流水线方式运行 pending 中的测试 (全局序号)，
+// 记录签名，或与 expected 比较并在不一致时定位第一个不一致的测试。返回进程退出码
+int run_signature(Simulator& sim, const SimOptions& opts, std::vector<TestCase>& tests,
+                  const std::vector<size_t>& pending, OutputSignature& sig, const OutputSignature* expected);
+
+#endif // __SIGNATURE_H__
@@ -0,0 +1,66 @@
+#ifndef __SIM_SERVER_H__
+#define __SIM_SERVER_H__
+
+#include <cstdint>
+
+#include "options.h"
+
+// ===================================================================
+// 常驻仿真服务 (--serve SOCKET)
+// ===================================================================
+// 服务进程保持若干个已构造、已复位的 Vtop 实例 (--serve-instances)，
+// 通过 Unix domain socket (SOCK_STREAM) 接收批量请求，每个连接一个线程，可发送多个请求。
+// 操作数与结果不经过 socket，而是放在客户端创建的 POSIX 共享内存 (shm_open) 中:
+//
+//   偏移 (字节)     内容
+//   0               uint32_t a[count]          按DUT端口打包的操作数 (与 TestCase::a_bits 相同)
+//   4 * count       uint32_t b[count]
+//   8 * count       uint32_t out[count]        DUT输出 (与 TestCase::packed_output 相同)
+//   12 * count      uint32_t mismatch[count]   检查时不通过的向量下标 (升序)
+//
+// 打包方式: FP32 为32位位模式; FP16/BF16 低16位为第1路、高16位为第2路;
+// FP16/BF16 Widen 的16位操作数位于高16位。所有字段为本机字节序 (小端)。
+// 请求与响应都是定长结构，Python 中可用 struct.pack("<IIIIQ64s", ...) 构造请求。
+const uint32_t kServerRequestMagic = 0x51534656;  // "VFSQ"
+const uint32_t kServerResponseMagic = 0x52534656; // "VFSR"
+
+enum class ServerOp : uint32_t {
+    Run = 0,      // 运行一批向量
+    Ping = 1,     // 只返回响应，用于等待服务就绪
+    Shutdown = 2, // 处理完正在运行的请求后退出
+};
+
+const uint32_t kServerCheck = 1u << 0; // 用 SoftFloat 参考模型检查，并写出 mismatch 下标
+
+struct ServerRequest {
+    uint32_t magic;
+    uint32_t op;          // ServerOp
+    uint32_t mode;        // TestMode
+    uint32_t flags;       // kServerCheck ...
+    uint64_t count;       // 向量个数，1 .. 2^32-1
+    char shm_name[64];    // 共享内存对象名 (例如 "/vfpu_batch")，以 '\0' 结尾
+};
+
+struct ServerResponse {
+    uint32_t magic;
+    int32_t status;       // 0 成功，其余见 ServerStatus
+    uint64_t count;       // 已写出的输出个数
+    uint64_t mismatches;  // mismatch 数组中的有效下标个数
+    uint64_t sim_ns;      // 仿真 (不含检查) 耗时
+};
+
+enum ServerStatus : int32_t {
+    kServerOk = 0,
+    kServerBadRequest = 1,  // magic/op/mode/count 不合法
+    kServerBadShm = 2,      // 共享内存无法打开或小于 16 * count 字节
+    kServerTimeout = 3,     // 等待 valid_out 超时
+    kServerInternalError = 4, // 处理请求时出现异常 (例如内存不足)
+};
+
+static_assert(sizeof(ServerRequest) == 88, "ServerRequest layout is part of the protocol");
+static_assert(sizeof(ServerResponse) == 32, "ServerResponse layout is part of the protocol");
+
+// --serve 入口，直到收到 Shutdown 请求才返回。返回进程退出码
+int run_server(const SimOptions& opts);
+
+#endif // __SIM_SERVER_H__
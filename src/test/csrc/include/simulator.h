@@ -2,38 +2,147 @@
 #define __SIMULATOR_H__
 
 #include <memory>
+#include <string>
+#include <vector>
 #include "test_case.h"
+#include "format_traits.h"
+#include "checkpoint.h"
+#include "issue_pattern.h"
+#include "stimulus_trace.h"
+#include "wave_trace.h"
+#include "activity.h"
 
 // 前向声明Verilator相关类
 class Vtop;
 class VerilatedContext;
 
-#ifdef VCD
-class VerilatedVcdC;
-#endif
+// 流水线批量执行的统计信息
+struct StreamStats {
+    uint64_t ops = 0;           // 已完成的操作数
+    uint64_t cycles = 0;        // 批量执行花费的周期数 (含排空)
+    uint64_t mode_switches = 0; // 相邻两个操作的 TestMode 不同的次数
+    uint64_t bubbles = 0;       // valid_in 为低的发射周期数
+    uint64_t latency_errors = 0; // valid_out 未按固定延迟出现的次数
+};
+
+// 按 TestMode 统计的 eval 开销 (--profile-eval)，排空周期计入最后发射的模式
+struct EvalProfile {
+    uint64_t ops[kNumTestModes] = {};
+    uint64_t cycles[kNumTestModes] = {};
+    uint64_t eval_ns[kNumTestModes] = {};
+};
 
 // ===================================================================
 // Simulator 类: 封装Verilator仿真控制
 // ===================================================================
 class Simulator {
 public:
-    Simulator(int argc, char* argv[]);
+    // threads: VerilatedContext 的线程数，0 表示使用 Verilator 的默认值。
+    // 多线程模型 (verilator --threads N) 要求 threads >= N
+    Simulator(int argc, char* argv[], unsigned threads = 0);
     ~Simulator();
 
-    bool run_test(const TestCase& test);
+    // 执行并检查一个测试; 等待 valid_out 超时时返回 false，并在 timed_out 非空时置为 true
+    bool run_test(const TestCase& test, bool* timed_out = nullptr);
     void reset(int n);
 
+    // 流水线方式连续执行一批测试 (每周期发射一个)，DUT输出按输入顺序写入 results。
+    // reset_dut 为 false 时不复位，DUT状态在批次之间保持 (用于 fuzzing)。
+    // 返回 false 表示等待 valid_out 超时
+    bool run_batch(const TestCase* tests, size_t n, DutOutputs* results, bool reset_dut = true);
+    const StreamStats& stream_stats() const { return stream_stats_; }
+
+    // 逐周期接口 (协程调度器 sequence.h 使用): 本周期发射 issue (nullptr 为空泡) 并推进一个周期，
+    // 该周期 valid_out 有效时把输出写入 out 并返回 true。不复位，也不检查延迟
+    bool step(const TestCase* issue, DutOutputs& out);
+
+    // 设置批量执行的发射模式; latency 为期望的流水线延迟，0 表示以首个结果测得的延迟为准
+    void set_issue_pattern(const IssuePattern& pattern, uint64_t latency = 0);
+    uint64_t pipeline_latency() const { return expected_latency_; }
+
+#ifdef WAVE_TRACE
+    // 打开波形文件，按 wave 限制跟踪的层次和周期
+    bool open_wave(const WaveOptions& wave);
+#endif
+
+    // 从现在起把每个周期驱动的输入记录到 path (--record-stimulus)，析构时写完
+    bool record_stimulus(const std::string& path);
+    // 逐周期回放记录的输入，并与记录中的 valid_out 和输出比较 (--replay-stimulus)。
+    // 返回 false 表示文件无法读取或已损坏
+    bool replay_stimulus(const std::string& path, StimulusReplayStats& stats);
+
+    // 统计选定信号的翻转活动，析构时打印汇总并写出 SAIF 文件 (--activity)。
+    // 信号名无法解析时返回 false
+    bool enable_activity(const ActivityOptions& opts);
+    // 之后的周期计入该激励来源 (例如 "corpus"、随机桶名)
+    void set_activity_source(const std::string& source) {
+        if (activity_) activity_->set_source(source);
+    }
+
+    // 测量每次 Vtop::eval() 的耗时并按当前模式累计
+    void enable_eval_profile(bool on) { profile_eval_ = on; }
+
+    // 模型编译时的线程数 (verilator --threads) 与 VerilatedContext 实际使用的线程数
+    unsigned model_threads() const;
+    unsigned context_threads() const;
+    // 不创建 Simulator 查询模型编译时的线程数 (用默认线程数的临时模型，结果缓存)，
+    // 用于在构造之前检查 --threads: 小于该值时 Verilator 会在创建模型时直接终止
+    static unsigned verilated_threads();
+    const EvalProfile& eval_profile() const { return eval_profile_; }
+
+#ifdef COVERAGE
+    // Verilator --coverage 生成的覆盖率计数器 (每个覆盖点一个)
+    const uint32_t* coverage_counters(size_t& count) const;
+    // 写出覆盖率数据库 (coverage.dat)
+    void write_coverage(const std::string& path);
+#endif
+
+    // 保存/恢复检查点: 测试平台状态 + (SAVABLE 编译时) Verilator 模型状态
+    bool save_checkpoint(const std::string& path, HarnessState state,
+                         const std::vector<uint64_t>& failed_tests);
+    bool restore_checkpoint(const std::string& path, HarnessState& state,
+                            std::vector<uint64_t>& failed_tests);
+
 private:
-    void init_vcd();
     void single_cycle();
-    
+    void eval();
+    DutOutputs read_outputs() const;
+
+    // 批量执行时按发射顺序收集输出
+    struct StreamState {
+        DutOutputs* results;
+        uint64_t* issue_cycles; // 每个操作被 valid_in 采样的周期
+        size_t issued;
+        size_t received;
+    };
+    bool collect_output(StreamState& st);
+    void drive_bubble();
+    template <TestMode M>
+    bool issue_homogeneous(const TestCase* tests, size_t n, StreamState& st);
+
+    uint64_t cycles_ = 0;
+    StreamStats stream_stats_;
+    IssueGenerator issue_gen_{IssuePattern()};
+    uint64_t expected_latency_ = 0;
+    std::vector<uint64_t> issue_cycles_;
+
+    std::unique_ptr<StimulusWriter> stimulus_;
+    std::unique_ptr<ActivityMonitor> activity_;
+    ActivityOptions activity_opts_;
+
+    bool profile_eval_ = false;
+    TestMode cur_mode_ = TestMode::FP32;
+    EvalProfile eval_profile_;
+
     // Verilator核心对象
     std::unique_ptr<VerilatedContext> contextp_;
     std::unique_ptr<Vtop> top_;
 
-    // VCD波形跟踪器
-#ifdef VCD
-    VerilatedVcdC* tfp_ = nullptr;
+    // 波形跟踪器 (VCD 或 FST)，只在周期 [wave_begin_, wave_end_) 内写入
+#ifdef WAVE_TRACE
+    WaveTracer* tfp_ = nullptr;
+    uint64_t wave_begin_ = 0;
+    uint64_t wave_end_ = 0;
 #endif
 };
 
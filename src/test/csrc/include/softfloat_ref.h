@@ -1,8 +1,38 @@
 #ifndef __SOFTFLOAT_REF_H__
 #define __SOFTFLOAT_REF_H__
 
+#include <cstddef>
 #include <cstdint>
 
+#include "test_case.h"
+
+// ===================================================================
+//  Reference engine on top of SoftFloat
+// ===================================================================
+// Every entry point is safe to call from several threads. SoftFloat keeps its
+// rounding mode and exception flags in globals declared THREAD_LOCAL, which is
+// empty unless SoftFloat is built with -DTHREAD_LOCAL=_Thread_local:
+//   - built that way and with -DSOFTFLOAT_TLS for this harness, each thread
+//     has its own state and the engine takes no lock;
+//   - otherwise the engine serializes SoftFloat calls with a mutex (batch entry
+//     points take it once per batch).
+// softfloat.h must not be included anywhere else, so that every translation
+// unit agrees on the storage of those globals.
+
+// Exception flags, same bit positions as SoftFloat and the RISC-V fflags CSR
+enum RefFlag : uint8_t {
+    kRefFlagNX = 0x01, // inexact
+    kRefFlagUF = 0x02, // underflow
+    kRefFlagOF = 0x04, // overflow
+    kRefFlagDZ = 0x08, // divide by zero (never raised by additions)
+    kRefFlagNV = 0x10, // invalid operation
+};
+
+struct RefResult {
+    uint32_t bits;  // result bit pattern, packed like TestCase::expected_bits
+    uint8_t flags;  // RefFlag bits; for dual FP16/BF16 beats, the OR of both lanes
+};
+
 // FP32 a + b, inputs and output are in uint32_t bit format
 uint32_t softfloat_add_fp32(uint32_t a, uint32_t b);
 
@@ -12,4 +42,26 @@ uint16_t softfloat_add_fp16(uint16_t a, uint16_t b);
 // BF16 a + b, inputs and output are in uint16_t bit format
 uint16_t softfloat_add_bf16(uint16_t a, uint16_t b);
 
-#endif // __SOFTFLOAT_REF_H__ 
\ No newline at end of file
+// Single operations with flags. Widen operands are FP16/BF16, results FP32.
+RefResult reference_add_fp32(uint32_t a, uint32_t b);
+RefResult reference_add_fp16(uint16_t a, uint16_t b);
+RefResult reference_add_bf16(uint16_t a, uint16_t b);
+RefResult reference_add_fp16_widen(uint16_t a, uint16_t b);
+RefResult reference_add_bf16_widen(uint16_t a, uint16_t b);
+
+// One DUT beat with operands packed like TestCase::a_bits/b_bits
+RefResult reference_add(TestMode mode, uint32_t a_bits, uint32_t b_bits);
+
+// n beats of one mode
+void reference_add_batch(TestMode mode, const uint32_t* a_bits, const uint32_t* b_bits, RefResult* out, size_t n);
+
+// Fills expected_bits and expected_flags of n tests (any mix of modes), like
+// TestCase::compute_expected; the flags are also copied to flags unless it is null
+void compute_expected_batch(TestCase* tests, size_t n, uint8_t* flags = nullptr);
+
+// SoftFloat conversions (RNE), used to validate fp_utils
+uint16_t reference_f32_to_f16(uint32_t bits);
+uint32_t reference_f16_to_f32(uint16_t bits);
+void reference_f32_to_f16_batch(const uint32_t* bits, uint16_t* out, size_t n);
+
+#endif // __SOFTFLOAT_REF_H__
@@ -0,0 +1,110 @@
+#ifndef __STIMULUS_TRACE_H__
+#define __STIMULUS_TRACE_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "test_case.h"
+
+// ===================================================================
+// 周期级激励记录与回放 (--record-stimulus / --replay-stimulus)
+// ===================================================================
+// 记录每个周期上升沿采样的全部 top 输入 (reset、valid_in、格式控制、操作数)，
+// 以及该周期 valid_out 有效时的输出。回放时把这些输入逐周期原样驱动到任意DUT构建，
+// 不需要重新生成向量或计算参考结果，空泡、模式切换、复位时序都与记录时一致。
+//
+// 文件格式 (小端): StimulusHeader，之后每个周期一条变长记录:
+//   tag 字节: bit0 控制位变化，bit1..6 依次为 a_in_32, b_in_32, a_in_16_0, a_in_16_1,
+//             b_in_16_0, b_in_16_1 变化，bit7 本周期 valid_out 有效;
+//   随后依次是变化的字段 (控制位 1 字节，其余按端口宽度) 和输出 (res_out_32, res_out_16_0,
+//   res_out_16_1，共 8 字节)。
+//   tag 为 0 时后跟一个 LEB128 变长整数 n: 连续 n 个周期输入不变且 valid_out 为低
+//   (流水线排空、空闲等待)。
+// 连续发射同一格式时每周期只有 1 字节 tag 加上变化的操作数。
+
+// 控制输入位
+enum StimulusCtrl : uint8_t {
+    kStimReset        = 0x01,
+    kStimValidIn      = 0x02,
+    kStimIsFp32       = 0x04,
+    kStimIsFp16       = 0x08,
+    kStimIsBf16       = 0x10,
+    kStimIsWiden      = 0x20,
+    kStimAlreadyWiden = 0x40,
+};
+
+// 一个周期内 top 的全部输入 (时钟除外)
+struct PortInputs {
+    uint8_t ctrl;           // StimulusCtrl 位
+    uint32_t a_in_32, b_in_32;
+    uint16_t a_in_16[2], b_in_16[2];
+};
+
+struct StimulusHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t cycles;        // 记录的周期数
+    uint64_t valid_outs;    // valid_out 有效的周期数
+};
+
+const uint32_t kStimulusMagic = 0x54535646; // "FVST"
+const uint32_t kStimulusVersion = 1;
+
+class StimulusWriter {
+public:
+    ~StimulusWriter() { close(); }
+
+    bool open(const std::string& path);
+    // 记录一个周期: 上升沿采样的输入，以及 valid_out 有效时的输出 (否则为 nullptr)
+    void cycle(const PortInputs& in, const DutOutputs* out);
+    // 写出剩余数据并回填文件头中的周期数
+    bool close();
+
+    uint64_t cycles() const { return header_.cycles; }
+
+private:
+    void flush_idle();
+    void flush_buffer();
+
+    FILE* fp_ = nullptr;
+    std::string path_;
+    StimulusHeader header_ = {};
+    PortInputs last_ = {};
+    uint64_t idle_ = 0;     // 尚未写出的空闲周期数
+    std::vector<uint8_t> buf_;
+    bool ok_ = true;
+};
+
+class StimulusReader {
+public:
+    bool open(const std::string& path);
+
+    // 读出下一个周期，文件结束或数据损坏时返回 false (用 corrupt() 区分)
+    bool next(PortInputs& in, bool& valid_out, DutOutputs& out);
+
+    const StimulusHeader& header() const { return header_; }
+    bool corrupt() const { return corrupt_; }
+
+private:
+    template <typename T>
+    bool read(T& v);
+
+    StimulusHeader header_ = {};
+    std::vector<uint8_t> data_;
+    size_t pos_ = 0;
+    PortInputs last_ = {};
+    uint64_t idle_ = 0;     // 当前空闲段剩余的周期数
+    bool corrupt_ = false;
+};
+
+// 回放结果: 与记录中的 valid_out 和输出比较
+struct StimulusReplayStats {
+    uint64_t cycles = 0;
+    uint64_t valid_outs = 0;      // 回放时 valid_out 有效的周期数
+    uint64_t mismatches = 0;      // valid_out 或输出与记录不一致的周期数
+    uint64_t first_mismatch = 0;  // 第一个不一致的周期 (从 1 开始)，0 表示一致
+};
+
+#endif // __STIMULUS_TRACE_H__
@@ -0,0 +1,31 @@
+#ifndef __SUITE_MIN_H__
+#define __SUITE_MIN_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simulator.h"
+
+// ===================================================================
+// 测试集精简 (suite minimization)
+// ===================================================================
+// 覆盖集合以 CSR 形式保存: 第 i 个向量的覆盖箱为 bins[offsets[i] .. offsets[i+1])
+struct CoverageSets {
+    std::vector<size_t> offsets{0};
+    std::vector<uint32_t> bins;
+
+    size_t size() const { return offsets.size() - 1; }
+};
+
+// 贪心集合覆盖: 先选入 forced 中的向量，再反复选择新增覆盖最多的向量，
+// 直到覆盖所有出现过的箱。返回选中向量的下标 (升序，保持原有顺序)
+std::vector<size_t> greedy_set_cover(const CoverageSets& sets, const std::vector<size_t>& forced);
+
+// --minimize 入口: 逐个运行向量池，记录每个向量的功能覆盖箱和 RTL 覆盖增量
+// (COVERAGE 编译时)，选出覆盖相同的最小子集写成向量包。失败的向量全部保留。
+// 返回进程退出码
+int minimize_suite(Simulator& sim, const std::vector<TestCase>& pool, const std::string& pack_path);
+
+#endif // __SUITE_MIN_H__
@@ -0,0 +1,35 @@
+#ifndef __TENSOR_NUMERICS_H__
+#define __TENSOR_NUMERICS_H__
+
+#include <cstdint>
+
+#include "options.h"
+
+// ===================================================================
+// 真实张量的数值仿真 (--npy-add / --npy-sum)
+// ===================================================================
+// 从内存映射的 .npy 文件读取张量，经 libvfpu_sim (vfpu_sim.h) 流过 Verilated 模型:
+//   --npy-add A B: 逐元素 A + B
+//   --npy-sum A:   沿最后一维的行归约，按两两配对的树形归约，每层的所有加法为一批
+// 结果与 FP64 参考 (double 运算) 比较，报告相对误差、以输出格式 ulp 计的误差，
+// 以及每秒处理的输入元素数。
+// --npy-widen 时 16 位输入使用 Widen 模式，结果 (以及归约的后续各层) 为 FP32，
+// 用于比较 16 位累加与扩展位宽累加的精度。
+
+// 误差统计
+struct TensorErrorStats {
+    uint64_t values = 0;      // 参与统计的结果个数
+    uint64_t nonfinite = 0;   // 参考或DUT结果为 Inf/NaN，不计入误差
+    double max_rel = 0;       // 参考值为0的结果不计入相对误差
+    double sum_rel = 0;
+    uint64_t rel_values = 0;
+    double max_ulp = 0;       // 以输出格式在参考值处的 ulp 为单位
+    double sum_ulp = 0;
+
+    void add(double got, double ref, int man_bits, int min_exp);
+};
+
+// --npy-add / --npy-sum 入口，返回进程退出码
+int run_tensor_numerics(const SimOptions& opts);
+
+#endif // __TENSOR_NUMERICS_H__
@@ -28,7 +28,7 @@ struct FADD_Operands_BF16_Widen {
 };
 
 // 定义测试模式的枚举类型
-enum class TestMode {
+enum class TestMode : uint8_t {
     FP32,
     FP16,
     BF16,
@@ -36,8 +36,12 @@ enum class TestMode {
     BF16_Widen
 };
 
+// TestMode 与名称 ("fp32", "fp16", "bf16", "fp16_widen", "bf16_widen") 之间的转换
+const char* test_mode_name(TestMode mode);
+bool parse_test_mode(const char* name, TestMode& mode);
+
 // 定义测试结果允许误差范围
-enum class ErrorType {
+enum class ErrorType : uint8_t {
     Precise,
     ULP, //允许若干 ulp (unit in the last place) 的误差
     RelativeError, // 相对误差
@@ -54,6 +58,12 @@ struct DutOutputs {
 // ===================================================================
 // TestCase 类: 封装单个测试用例
 // ===================================================================
+// 紧凑表示 (16字节): 操作数和期望结果都按DUT的32位端口打包，期望的异常标志占用1字节，
+//   FP32:        a_bits/b_bits 为FP32位模式，expected_bits 为FP32结果
+//   FP16/BF16:   低16位为第1路 (io_*_16_0)，高16位为第2路 (io_*_16_1)
+//   FP16/BF16 Widen: 16位操作数位于高16位 (与 FAdd_16_32 的约定一致)，
+//                expected_bits 为FP32结果
+// 浮点数值等仅用于打印和误差计算的信息按需从位模式计算。
 class TestCase {
 public:
     // 构造函数 for FP32 single operation using hexadecimal input
@@ -71,38 +81,52 @@ public:
     // 构造函数 for BF16 widen operation using hexadecimal input (a,b are BF16, result is FP32)
     TestCase(const FADD_Operands_BF16_Widen& ops_widen, ErrorType error_type = ErrorType::ULP);
     
+    // 用 SoftFloat 参考模型计算 expected_bits 和 expected_flags
+    void compute_expected();
+
     void print_details() const;
     bool check_result(const DutOutputs& dut_res) const;
 
+    // --- 控制信号视图 ---
+    bool is_fp32() const { return mode == TestMode::FP32; }
+    bool is_fp16() const { return mode == TestMode::FP16 || mode == TestMode::FP16_Widen; }
+    bool is_bf16() const { return mode == TestMode::BF16 || mode == TestMode::BF16_Widen; }
+    bool is_widen() const { return mode == TestMode::FP16_Widen || mode == TestMode::BF16_Widen; }
+
+    // --- 16位视图: lane 0 为低16位 (io_*_16_0)，lane 1 为高16位 (io_*_16_1) ---
+    uint16_t a16(int lane) const { return (uint16_t)(a_bits >> (16 * lane)); }
+    uint16_t b16(int lane) const { return (uint16_t)(b_bits >> (16 * lane)); }
+    uint16_t expected16(int lane) const { return (uint16_t)(expected_bits >> (16 * lane)); }
+
+    // DUT输出按 expected_bits 的方式打包: FP16/BF16 为 {res_out_16_1, res_out_16_0}，其余为 res_out_32
+    uint32_t packed_output(const DutOutputs& out) const {
+        return (mode == TestMode::FP16 || mode == TestMode::BF16)
+               ? (((uint32_t)out.res_out_16_1 << 16) | out.res_out_16_0) : out.res_out_32;
+    }
+
+    // --- 公共数据成员，供 Simulator 直接访问 ---
+    uint32_t a_bits, b_bits;   // 打包后的操作数，即DUT的 a/b 输入
+    uint32_t expected_bits;    // 打包后的期望结果
     TestMode mode;
     ErrorType error_type;
+    uint8_t expected_flags;    // 期望的异常标志 (RefFlag: NV/OF/UF/NX，双路模式为两路之或)
 
-    // --- 公共数据成员，供 Simulator 直接访问 ---
-    // 控制信号
-    bool is_fp32, is_fp16, is_bf16, is_widen;
+private:
+    void compute_expected_if_enabled();
 
-    // FP32 模式数据
-    uint32_t a_fp32_bits, b_fp32_bits;
+    // 16位操作数对应的FP32数值，用于打印和相对误差计算
+    float f16_value(uint16_t bits) const;
+};
 
-    // FP16 模式数据
-    uint16_t a1_fp16_bits, b1_fp16_bits;
-    uint16_t a2_fp16_bits, b2_fp16_bits;
+// 关闭后新构造的 TestCase 不计算期望结果 (expected_bits 为0)，用于只比较输出签名的回归，
+// 需要时再对个别向量调用 compute_expected()
+void set_reference_enabled(bool enabled);
 
-    // BF16 模式数据
-    uint16_t a1_bf16_bits, b1_bf16_bits;
-    uint16_t a2_bf16_bits, b2_bf16_bits;
+static_assert(sizeof(TestCase) == 16, "TestCase must stay compact");
 
-private:
-    // 原始浮点数值，用于打印和计算期望结果
-    // FP32 - now using the struct for consistency
-    FADD_Operands op_fp;
-    // FP16 - uses the struct
-    FADD_Operands op1_fp, op2_fp;
-
-    // 期望结果
-    uint32_t expected_res_fp32;
-    uint16_t expected_res1_fp16, expected_res2_fp16;
-    uint16_t expected_res1_bf16, expected_res2_bf16;
-};
+// 按 (TestMode, ErrorType) 编译期特化的结果检查函数 (不含 PASS/FAIL 汇总打印)，
+// 同构的一批测试可以只查一次表，然后直接调用
+typedef bool (*CheckFn)(const TestCase& test, const DutOutputs& dut_res);
+CheckFn check_function(TestMode mode, ErrorType error_type);
 
 #endif // __TEST_CASE_H__ 
\ No newline at end of file
@@ -1,17 +1,68 @@
 #ifndef __TEST_FACTORY_H__
 #define __TEST_FACTORY_H__
 
+#include <string>
 #include <vector>
 #include "test_case.h"
 
-// Creates and returns a vector of all test cases.
-std::vector<TestCase> create_all_tests();
+// Selects which test groups are generated and how many random vectors
+// each random bucket produces.
+struct TestSelection {
+    bool test_fp32 = true;
+    bool test_fp16 = true;
+    bool test_bf16 = true;
+    bool test_fp16_widen = true;
+    bool test_bf16_widen = true;
+    bool test_mixed = false;    // 每周期切换格式的混合模式流水线测试
+    int num_random_tests = 200;
+};
+
+// ===================================================================
+// 随机测试桶 (random bucket): 一类随机向量的操作数分布
+// ===================================================================
+// 操作数由指数范围 [min, max] 描述 (gen_random_*)，kAnyValue 表示任意值 (gen_any_*)。
+// FP32/Widen 只使用 a, b; FP16/BF16 的两路分别为 {a, b} 和 {a1, b1}。
+struct ExpRange {
+    int min, max;
+};
+const ExpRange kAnyValue = {1, 0};
+
+struct RandomBucket {
+    TestMode mode;
+    ExpRange a, b;
+    ExpRange a1 = kAnyValue, b1 = kAnyValue;
+    int count_divisor = 1;    // 固定向量数为 num_random_tests / count_divisor
+    ErrorType error_type = ErrorType::Precise;
+};
+
+// 每种模式的随机测试桶，按生成顺序排列
+const std::vector<RandomBucket>& random_buckets(TestMode mode);
+// 桶的可读名称，例如 "bf16 a[-50,-10] b[-50,-10]"
+std::string bucket_name(const RandomBucket& bucket);
+// 按桶的分布生成随机向量
+TestCase random_bucket_test(const RandomBucket& bucket);
+void add_bucket_tests(std::vector<TestCase>& tests, const RandomBucket& bucket, int count);
+
+// Comma separated list of the selected modes, e.g. "fp32,bf16".
+std::string selection_modes(const TestSelection& sel);
+
+// Creates and returns a vector of all selected test cases.
+std::vector<TestCase> create_all_tests(const TestSelection& sel = TestSelection());
+
+// 测试序列的摘要 (FNV-1a，覆盖模式、操作数和误差类型)，相同 seed 和选项应得到相同的摘要
+uint64_t suite_digest(const std::vector<TestCase>& tests);
 
 // Declarations for split test functions
-void add_fp32_tests(std::vector<TestCase>& tests);
-void add_fp16_tests(std::vector<TestCase>& tests);
-void add_bf16_tests(std::vector<TestCase>& tests);
-void add_fp16_widen_tests(std::vector<TestCase>& tests);
-void add_bf16_widen_tests(std::vector<TestCase>& tests);
+const std::vector<RandomBucket>& fp32_random_buckets();
+const std::vector<RandomBucket>& fp16_random_buckets();
+const std::vector<RandomBucket>& bf16_random_buckets();
+const std::vector<RandomBucket>& fp16_widen_random_buckets();
+const std::vector<RandomBucket>& bf16_widen_random_buckets();
+void add_fp32_tests(std::vector<TestCase>& tests, int num_random_tests);
+void add_fp16_tests(std::vector<TestCase>& tests, int num_random_tests);
+void add_bf16_tests(std::vector<TestCase>& tests, int num_random_tests);
+void add_fp16_widen_tests(std::vector<TestCase>& tests, int num_random_tests);
+void add_bf16_widen_tests(std::vector<TestCase>& tests, int num_random_tests);
+void add_mixed_stream_tests(std::vector<TestCase>& tests, int num_random_tests);
 
-#endif // __TEST_FACTORY_H__ 
\ No newline at end of file
+#endif // __TEST_FACTORY_H__ 
@@ -0,0 +1,30 @@
+#ifndef __VECTOR_PACK_H__
+#define __VECTOR_PACK_H__
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "test_case.h"
+
+// ===================================================================
+// 向量包 (vector pack): 可直接回放的测试向量集合
+// ===================================================================
+// 文件格式: VectorPackHeader + count 个 16 字节的 TestCase 记录 (含期望结果)，
+// 回放时无需重新生成向量或计算参考结果。
+struct VectorPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count;
+};
+
+const uint32_t kVectorPackMagic = 0x4B505646; // "FVPK"
+const uint32_t kVectorPackVersion = 2; // 2: 记录含 expected_flags
+
+static_assert(std::is_trivially_copyable<TestCase>::value, "TestCase is stored as raw records");
+
+bool write_vector_pack(const std::string& path, const std::vector<TestCase>& tests);
+bool read_vector_pack(const std::string& path, std::vector<TestCase>& tests);
+
+#endif // __VECTOR_PACK_H__
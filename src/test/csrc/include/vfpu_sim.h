@@ -0,0 +1,72 @@
+#ifndef __VFPU_SIM_H__
+#define __VFPU_SIM_H__
+
+/*
+ * ===================================================================
+ * libvfpu_sim: 通过 Verilator 模型进行批量浮点加法的 C API
+ * ===================================================================
+ * 结果与 RTL 逐位一致: 每个元素都流经 Verilated 的 top (FAdd_16_32)，
+ * 按流水线方式每周期发射一拍。
+ *
+ * 构建: 与测试平台使用相同的源文件和 Verilator 模型，定义 VFPU_LIB
+ * (不生成 main)，用 -fPIC 编译并链接为 libvfpu_sim.so。
+ *
+ * 所有数组为位模式 (FP32 为 uint32_t，FP16/BF16 为 uint16_t)，不要求对齐。
+ * FP16/BF16 每拍计算两个元素 (DUT的两路)，元素个数为奇数时最后一拍的第2路补0。
+ * Widen 模式的输入为 FP16/BF16，结果为 FP32。
+ *
+ * vfpu_add_* 使用进程内共享的默认实例，内部加锁，可从多个线程调用 (串行执行);
+ * 需要并行时每个线程用 vfpu_sim_create 创建自己的实例。单个实例不是线程安全的。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VFPU_SIM_API_VERSION 1
+
+typedef enum vfpu_mode {
+    VFPU_MODE_FP32 = 0,
+    VFPU_MODE_FP16 = 1,
+    VFPU_MODE_BF16 = 2,
+    VFPU_MODE_FP16_WIDEN = 3,
+    VFPU_MODE_BF16_WIDEN = 4
+} vfpu_mode;
+
+typedef enum vfpu_status {
+    VFPU_OK = 0,
+    VFPU_ERR_ARG = 1,      /* 空指针或非法模式 */
+    VFPU_ERR_TIMEOUT = 2,  /* 等待 valid_out 超时，模型状态已失效 */
+    VFPU_ERR_INIT = 3      /* 无法创建模型 */
+} vfpu_status;
+
+/* 运行时库的 API 版本，应与 VFPU_SIM_API_VERSION 相同 */
+int vfpu_sim_api_version(void);
+
+typedef struct vfpu_sim vfpu_sim;
+
+vfpu_sim* vfpu_sim_create(void);
+void vfpu_sim_destroy(vfpu_sim* sim);
+
+/* out[i] = a[i] + b[i]，i < n。a/b/out 的元素类型由 mode 决定 (见上) */
+int vfpu_sim_add(vfpu_sim* sim, vfpu_mode mode, const void* a, const void* b, void* out, size_t n);
+
+/* 使用默认实例的类型化接口 */
+int vfpu_add_fp32(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n);
+int vfpu_add_fp16(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n);
+int vfpu_add_bf16(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n);
+int vfpu_add_fp16_widen(const uint16_t* a, const uint16_t* b, uint32_t* out, size_t n);
+int vfpu_add_bf16_widen(const uint16_t* a, const uint16_t* b, uint32_t* out, size_t n);
+
+#ifdef __cplusplus
+}
+
+/* 测试平台内部使用 (不属于 C API): 实例所用的 Simulator，例如开启翻转统计 */
+class Simulator;
+Simulator* vfpu_sim_simulator(vfpu_sim* sim);
+#endif
+
+#endif /* __VFPU_SIM_H__ */
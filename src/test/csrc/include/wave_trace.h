@@ -0,0 +1,44 @@
+#ifndef __WAVE_TRACE_H__
+#define __WAVE_TRACE_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// 波形跟踪 (VCD / FST)
+// ===================================================================
+// 编译选项:
+//   -DVCD  模型用 verilator --trace 生成，写未压缩的 VCD
+//   -DFST  模型用 verilator --trace-fst --trace-threads 2 生成，写压缩的 FST;
+//          --trace-threads 让 Verilator 在单独的线程中完成格式化和压缩，
+//          仿真线程每次 dump 只需复制发生变化的信号
+// 两者都定义时使用 FST。跟踪范围由命令行限制 (--wave-scope/--wave-depth/--wave-cycles)，
+// 只跟踪调试需要的模块和周期，波形文件与仿真开销都与跟踪的信号数和周期数成正比。
+
+#if defined(FST)
+class VerilatedFstC;
+typedef VerilatedFstC WaveTracer;
+#define WAVE_TRACE
+#define WAVE_DEFAULT_PATH "build/vfpu/top.fst"
+#elif defined(VCD)
+class VerilatedVcdC;
+typedef VerilatedVcdC WaveTracer;
+#define WAVE_TRACE
+#define WAVE_DEFAULT_PATH "build/vfpu/top.vcd"
+#endif
+
+struct WaveOptions {
+    std::string path;                   // --wave: 空表示默认路径
+    int depth = 99;                     // --wave-depth: 从 top 起跟踪的层数
+    std::vector<std::string> scopes;    // --wave-scope: 只跟踪这些层次及其下层 (例如 TOP.top.fadd)，空表示全部
+    uint64_t begin_cycle = 0;           // --wave-cycles A:B: 只写出周期 [A, B) 的波形
+    uint64_t end_cycle = 0;             //   0 表示不限
+
+    // 是否设置了任何跟踪选项 (没有编译跟踪支持时据此给出警告)
+    bool customized() const {
+        return !path.empty() || depth != 99 || !scopes.empty() || begin_cycle || end_cycle;
+    }
+};
+
+#endif // __WAVE_TRACE_H__
@@ -0,0 +1,64 @@
+#include "include/issue_pattern.h"
+
+#include <cstdio>
+#include <cstring>
+
+const char* issue_kind_name(IssueKind kind) {
+    switch (kind) {
+        case IssueKind::Full:      return "full";
+        case IssueKind::Bernoulli: return "bernoulli";
+        case IssueKind::Burst:     return "burst";
+        case IssueKind::Periodic:  return "periodic";
+    }
+    return "unknown";
+}
+
+std::string issue_pattern_text(const IssuePattern& pattern) {
+    char text[64];
+    switch (pattern.kind) {
+        case IssueKind::Bernoulli:
+            snprintf(text, sizeof(text), "bernoulli:%.17g", pattern.probability);
+            return text;
+        case IssueKind::Burst:
+            snprintf(text, sizeof(text), "burst:%u:%u", pattern.burst, pattern.gap);
+            return text;
+        case IssueKind::Periodic:
+            snprintf(text, sizeof(text), "periodic:%u", pattern.period);
+            return text;
+        default:
+            return issue_kind_name(pattern.kind);
+    }
+}
+
+bool parse_issue_pattern(const char* text, IssuePattern& pattern) {
+    pattern = IssuePattern();
+    if (strcmp(text, "full") == 0) {
+        return true;
+    }
+    if (sscanf(text, "bernoulli:%lf", &pattern.probability) == 1) {
+        pattern.kind = IssueKind::Bernoulli;
+        if (pattern.probability <= 0.0 || pattern.probability > 1.0) {
+            printf("Bernoulli issue probability must be in (0, 1]\n");
+            return false;
+        }
+        return true;
+    }
+    if (sscanf(text, "burst:%u:%u", &pattern.burst, &pattern.gap) == 2) {
+        pattern.kind = IssueKind::Burst;
+        if (pattern.burst == 0) {
+            printf("Burst length must be positive\n");
+            return false;
+        }
+        return true;
+    }
+    if (sscanf(text, "periodic:%u", &pattern.period) == 1) {
+        pattern.kind = IssueKind::Periodic;
+        if (pattern.period < 2) {
+            printf("Bubble period must be at least 2\n");
+            return false;
+        }
+        return true;
+    }
+    printf("Unknown issue pattern: %s\n", text);
+    return false;
+}
@@ -1,40 +1,420 @@
 #include "include/simulator.h"
 #include "include/test_factory.h"
+#include "include/checkpoint.h"
+#include "include/options.h"
+#include "include/result_file.h"
+#include "include/batch_check.h"
+#include "include/adaptive.h"
+#include "include/signature.h"
+#include "include/perf_trace.h"
+#include "include/coverage_db.h"
+#include "include/suite_min.h"
+#include "include/vector_pack.h"
+#include "include/rtl_profile.h"
+#include "include/autotune.h"
+#include "include/sim_server.h"
+#include "include/tensor_numerics.h"
+#include "include/sequence.h"
+#include "include/conversion_sweep.h"
+#include "include/failure_corpus.h"
 #include <vector>
+#include <algorithm>
+#include <string>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <chrono>
 
+#if !defined(FUZZ) && !defined(VFPU_LIB)
+// --replay-stimulus: 逐周期回放记录的输入，返回进程退出码
+static int replay_stimulus(Simulator& sim, const std::string& path) {
+  auto begin = std::chrono::steady_clock::now();
+  StimulusReplayStats stats;
+  if (!sim.replay_stimulus(path, stats)) {
+    return 1;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  printf("Replayed %llu cycles from %s in %.3f s (%.0f cycles/s), %llu valid_out\n",
+         (unsigned long long)stats.cycles, path.c_str(), seconds, seconds > 0 ? stats.cycles / seconds : 0.0,
+         (unsigned long long)stats.valid_outs);
+  if (stats.mismatches) {
+    printf("%llu cycles differ from the recording, first at cycle %llu\n", (unsigned long long)stats.mismatches,
+           (unsigned long long)stats.first_mismatch);
+    return 1;
+  }
+  printf("valid_out and results match the recording on every cycle\n");
+  return 0;
+}
+#endif
+
+// 使用 libFuzzer 构建 (-DFUZZ) 时由 libFuzzer 提供 main，入口见 fuzz_main.cpp;
+// 构建 libvfpu_sim (-DVFPU_LIB) 时没有 main，入口见 vfpu_sim.h
+#if !defined(FUZZ) && !defined(VFPU_LIB)
 int main(int argc, char *argv[]) {
-  // 1. 初始化随机数生成器种子
-  srand(time(NULL)); 
+  // 0. 解析命令行参数
+  SimOptions opts;
+  if (!parse_options(argc, argv, opts)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+  if (opts.show_help) {
+    print_usage(argv[0]);
+    return 0;
+  }
+  if (!opts.merge_inputs.empty()) {
+    return merge_result_files(opts.merge_inputs, opts.result_path);
+  }
+  if (!opts.coverage_inputs.empty()) {
+    return merge_coverage_files(opts.coverage_inputs, opts.coverage_path);
+  }
+  if (!opts.prof_inputs.empty()) {
+    return rtl_profile_report(opts.prof_inputs);
+  }
 
-  // 2. 初始化仿真器
-  Simulator sim(argc, argv);
+  // 性能跟踪 (PERF_TRACE 编译时): 退出时写出 Chrome trace-event JSON
+#ifdef PERF_TRACE
+  set_trace_output(opts.trace_path.empty() ? "perf_trace.json" : opts.trace_path);
+#else
+  if (!opts.trace_path.empty()) {
+    printf("WARNING: --trace ignored, rebuild with -DPERF_TRACE\n");
+  }
+#endif
 
-  // 3. 使用 TestFactory 创建所有测试用例
-  printf("--- Creating all test cases ---\n");
-  std::vector<TestCase> tests = create_all_tests();
-  printf("--- All test cases created ---\n\n");
-
-  // 4. 执行所有测试，遇到错误即停止
-  for (size_t i = 0; i < tests.size(); ++i) {
-    printf("--- Running test case %zu of %zu ---\n", i + 1, tests.size());
-    if (!sim.run_test(tests[i])) {
+  if (opts.conversion_sweep) {
+    return run_conversion_sweep(opts.sweep_threads, opts.sweep_step);
+  }
+  // 线程数小于模型编译时的 --threads 时 Verilator 会在创建模型时终止，先给出错误
+  if (opts.threads && opts.threads < Simulator::verilated_threads()) {
+    printf("Invalid value for --threads: %u, the model was verilated with --threads %u\n", opts.threads,
+           Simulator::verilated_threads());
+    return 1;
+  }
+  if (!opts.npy_inputs.empty()) {
+    return run_tensor_numerics(opts);
+  }
+  if (!opts.serve_path.empty()) {
+    return run_server(opts);
+  }
+  if (opts.autotune) {
+    srand(opts.seed_set ? opts.seed : (uint32_t)time(NULL));
+    return run_autotune(opts);
+  }
+
+  // 1. 初始化仿真器
+  Simulator sim((int)opts.verilator_args.size(), opts.verilator_args.data(), opts.threads);
+  sim.set_issue_pattern(opts.issue, opts.latency);
+  sim.enable_eval_profile(opts.profile_eval);
+#ifdef WAVE_TRACE
+  if (!sim.open_wave(opts.wave)) {
+    return 1;
+  }
+#else
+  if (opts.wave.customized()) {
+    printf("WARNING: --wave options ignored, rebuild with -DFST and verilator --trace-fst (or -DVCD and --trace)\n");
+  }
+#endif
+  if (!opts.record_stimulus_path.empty() && !sim.record_stimulus(opts.record_stimulus_path)) {
+    return 1;
+  }
+  if (!opts.activity.prefix.empty() && !sim.enable_activity(opts.activity)) {
+    return 1;
+  }
+  if (!opts.replay_stimulus_path.empty()) {
+    sim.set_activity_source("stimulus_replay");
+    return replay_stimulus(sim, opts.replay_stimulus_path);
+  }
+
+  // 2. 初始化随机数生成器种子 (续跑时使用检查点中保存的种子)
+  HarnessState state = {};
+  std::vector<uint64_t> failed_tests;
+  state.seed = opts.seed_set ? opts.seed : (uint32_t)time(NULL);
+  if (!opts.restore_path.empty()) {
+    if (!sim.restore_checkpoint(opts.restore_path, state, failed_tests)) {
+      return 1;
+    }
+    if (opts.seed_set && opts.seed != state.seed) {
+      printf("Checkpoint %s was written with seed %u, not %u\n", opts.restore_path.c_str(), state.seed, opts.seed);
+      return 1;
+    }
+    printf("--- Restored checkpoint %s: seed=%u, next test %llu ---\n", opts.restore_path.c_str(),
+           state.seed, (unsigned long long)state.next_test + 1);
+  }
+  // 与签名比较时使用签名记录的种子
+  OutputSignature expected_sig;
+  if (!opts.signature_path.empty()) {
+    if (!read_signature_file(opts.signature_path, expected_sig)) {
+      return 1;
+    }
+    if (!opts.seed_set) state.seed = expected_sig.seed;
+  }
+  const bool signature_mode = !opts.signature_path.empty() || !opts.record_signature_path.empty();
+  srand(state.seed);
+
+  // 先回放失败语料库中已知出错的向量 (签名模式不计算参考结果，不回放)
+  FailureCorpus corpus;
+  int64_t corpus_failed = 0;
+  if (!signature_mode && !opts.corpus_path.empty()) {
+    if (!corpus.load(opts.corpus_path)) {
+      return 1;
+    }
+    sim.set_activity_source("corpus");
+    corpus_failed = replay_corpus(sim, corpus, opts);
+    if (corpus_failed < 0) {
+      return 1;
+    }
+    if (opts.max_failures > 0 && (uint64_t)corpus_failed >= opts.max_failures) {
       printf("\n=================================\n");
       printf("      TEST FAILED!\n");
       printf("=================================\n");
-      printf("Failed on test case %zu.\n", i + 1);
-      return 1; // 返回非零值表示失败
+      printf("%lld failure corpus vectors still fail\n", (long long)corpus_failed);
+      return 1;
+    }
+  }
+  // 回放会消耗 rand() (空泡、Bernoulli 发射)，重新设置种子，
+  // 使测试序列和发射时序只由 seed 决定，与语料库的大小无关
+  srand(state.seed);
+
+  if (opts.adaptive) {
+    int rc = run_adaptive(sim, opts, state.seed, &corpus);
+    if (corpus_failed > 0) {
+      printf("%lld failure corpus vectors still fail\n", (long long)corpus_failed);
+      return 1;
+    }
+    return rc;
+  }
+
+  sim.set_activity_source(opts.pack_path.empty() ? "suite" : "pack");
+
+  // 3. 使用 TestFactory 创建所有测试用例
+  //    所有分片使用相同的 seed 生成完整的测试序列，再按序号划分，保证分片结果确定
+  //    --pack 时直接回放向量包中的向量
+  std::vector<TestCase> tests;
+  uint64_t digest = 0;
+  if (!opts.pack_path.empty()) {
+    if (!read_vector_pack(opts.pack_path, tests)) {
+      return 1;
+    }
+    digest = suite_digest(tests);
+    printf("--- Loaded %zu test cases from %s (digest %016llx) ---\n\n", tests.size(), opts.pack_path.c_str(),
+           (unsigned long long)digest);
+  } else {
+    // 签名模式只比较输出哈希，生成向量时不计算参考结果
+    set_reference_enabled(!signature_mode);
+    printf("--- Creating all test cases ---\n");
+    tests = create_all_tests(opts.selection);
+    digest = suite_digest(tests);
+    printf("--- All test cases created (%zu, digest %016llx) ---\n\n", tests.size(), (unsigned long long)digest);
+  }
+  const std::string modes = opts.pack_path.empty() ? selection_modes(opts.selection) : "pack";
+  if (!opts.minimize_path.empty()) {
+    return minimize_suite(sim, tests, opts.minimize_path);
+  }
+
+  ShardResult result;
+  result.seed = state.seed;
+  result.shard_index = opts.shard_index;
+  result.shard_count = opts.shard_count;
+  result.modes = modes;
+  result.num_random_tests = opts.selection.num_random_tests;
+  for (size_t i = opts.shard_index; i < tests.size(); i += opts.shard_count) {
+    result.total++;
+  }
+
+  // 续跑时检查点必须属于同一个 campaign，之后写出的检查点记录本次的 campaign
+  if (!opts.restore_path.empty()
+      && (state.shard_index != opts.shard_index || state.shard_count != opts.shard_count
+          || strncmp(state.modes, modes.c_str(), sizeof(state.modes)) != 0
+          || state.num_random_tests != opts.selection.num_random_tests || state.suite_digest != digest)) {
+    printf("Checkpoint %s belongs to a different campaign (shard %u/%u, modes %.*s, count %d, digest %016llx),\n"
+           "refusing to restore into shard %u/%u, modes %s, count %d, digest %016llx\n",
+           opts.restore_path.c_str(), state.shard_index, state.shard_count, (int)sizeof(state.modes), state.modes,
+           state.num_random_tests, (unsigned long long)state.suite_digest, opts.shard_index, opts.shard_count,
+           modes.c_str(), opts.selection.num_random_tests, (unsigned long long)digest);
+    return 1;
+  }
+  state.shard_index = opts.shard_index;
+  state.shard_count = opts.shard_count;
+  state.num_random_tests = opts.selection.num_random_tests;
+  state.suite_digest = digest;
+  snprintf(state.modes, sizeof(state.modes), "%s", modes.c_str());
+
+  // 4. 执行本分片的测试，失败数达到 max_failures 时停止
+  //    --stream 时以流水线方式每次连续执行 batch_size 个测试，批次之间写检查点
+  std::vector<size_t> pending; // 本分片待执行测试的全局序号
+  size_t first = state.next_test;
+  while (first % opts.shard_count != opts.shard_index) first++;
+  for (size_t i = first; i < tests.size(); i += opts.shard_count) {
+    pending.push_back(i);
+  }
+
+  if (signature_mode) {
+    OutputSignature sig;
+    sig.seed = state.seed;
+    sig.shard_index = opts.shard_index;
+    sig.shard_count = opts.shard_count;
+    sig.modes = result.modes;
+    sig.num_random_tests = result.num_random_tests;
+    sig.batch_size = opts.batch_size;
+    sig.issue = issue_pattern_text(opts.issue);
+    sig.block = opts.signature_block;
+    return run_signature(sim, opts, tests, pending, sig, opts.signature_path.empty() ? nullptr : &expected_sig);
+  }
+
+  // 记录一个测试的结果，达到失败预算时返回 false
+  // 超时的测试 (流式执行时为整批) 记为失败，但这些向量不一定出错，不加入失败语料库
+  auto record = [&](size_t i, bool pass, bool timed_out = false) {
+    if (pass) {
+      state.passed++;
+      return true;
+    }
+    failed_tests.push_back(i);
+    if (!timed_out) {
+      corpus.add(tests[i]);
+    }
+    printf("Failed on test case %zu (seed %u).\n", i + 1, state.seed);
+    return !(opts.max_failures > 0 && failed_tests.size() >= opts.max_failures);
+  };
+
+  const size_t batch_size = opts.stream ? opts.batch_size : 1;
+  std::vector<TestCase> batch;
+  std::vector<DutOutputs> outputs;
+  BatchChecker checker;
+  uint64_t since_checkpoint = 0;
+  bool keep_going = true;
+  if (opts.sequences) {
+    // 并发序列一次执行本分片的全部待测向量 (不写检查点)，结果与逐个执行时一样记录
+    std::vector<size_t> seq_failed;
+    uint64_t seq_passed = 0;
+    sim.set_activity_source("sequences");
+    if (!run_sequences(sim, tests, pending, opts.sequences, opts.sequence_window, opts.max_failures, seq_failed,
+                       seq_passed)) {
+      return 1;
+    }
+    state.passed += seq_passed;
+    for (size_t i : seq_failed) {
+      record(i, false);
+    }
+    keep_going = false;
+  }
+  for (size_t pos = 0; pos < pending.size() && keep_going; pos += batch_size) {
+    size_t count = std::min(batch_size, pending.size() - pos);
+    if (!opts.checkpoint_path.empty() && opts.checkpoint_every > 0 && since_checkpoint >= opts.checkpoint_every) {
+      HarnessState cp = state;
+      cp.next_test = pending[pos];
+      sim.save_checkpoint(opts.checkpoint_path, cp, failed_tests);
+      since_checkpoint = 0;
+    }
+    since_checkpoint += count;
+
+    if (!opts.stream) {
+      size_t i = pending[pos];
+      printf("--- Running test case %zu of %zu ---\n", i + 1, tests.size());
+      bool timed_out = false;
+      bool pass = sim.run_test(tests[i], &timed_out);
+      keep_going = record(i, pass, timed_out);
+      continue;
+    }
+
+    TRACE_SCOPE("stream_batch");
+    batch.clear();
+    for (size_t k = 0; k < count; ++k) {
+      batch.push_back(tests[pending[pos + k]]);
+    }
+    outputs.resize(count);
+    printf("--- Streaming test cases %zu..%zu of %zu ---\n", pending[pos] + 1,
+           pending[pos + count - 1] + 1, tests.size());
+    if (!sim.run_batch(batch.data(), count, outputs.data())) {
+      // 超时后本批次的结果不可信，整批记为失败
+      for (size_t k = 0; k < count && keep_going; ++k) {
+        keep_going = record(pending[pos + k], false, true);
+      }
+      break;
+    }
+    // 快速路径检查整批结果，只对不匹配的向量打印详细信息
+    TRACE_SCOPE("check_batch");
+    const std::vector<size_t>& mismatches = checker.fast_check(batch.data(), outputs.data(), count);
+    size_t checked = 0;
+    for (size_t k : mismatches) {
+      state.passed += k - checked;
+      size_t i = pending[pos + k];
+      printf("--- Checking test case %zu of %zu ---\n", i + 1, tests.size());
+      batch[k].print_details();
+      keep_going = record(i, batch[k].check_result(outputs[k]));
+      checked = k + 1;
+      if (!keep_going) break;
+    }
+    if (keep_going) {
+      state.passed += count - checked;
+    }
+  }
+
+  result.passed = state.passed;
+  result.failed = failed_tests.size();
+  result.run = result.passed + result.failed;
+  for (uint64_t index : failed_tests) {
+    result.failures.push_back(FailureRecord{index, tests[index].mode});
+  }
+  if (!opts.result_path.empty()) {
+    TRACE_SCOPE("write_result_file");
+    write_result_file(opts.result_path, result);
+  }
+
+  // 写出本分片的覆盖率数据库，之后用 --coverage-merge 合并
+#ifdef COVERAGE
+  std::string coverage_path = opts.coverage_path;
+  if (coverage_path.empty()) {
+    coverage_path = opts.shard_count > 1 ? "coverage_" + std::to_string(opts.shard_index) + "_"
+                                             + std::to_string(opts.shard_count) + ".dat"
+                                         : "coverage.dat";
+  }
+  sim.write_coverage(coverage_path);
+  printf("Coverage written to %s\n", coverage_path.c_str());
+#else
+  if (!opts.coverage_path.empty()) {
+    printf("WARNING: --coverage ignored, rebuild with -DCOVERAGE and verilator --coverage\n");
+  }
+#endif
+
+  if (opts.stream) {
+    const StreamStats& st = sim.stream_stats();
+    printf("Streamed %llu ops in %llu cycles (%llu mode switches, %llu bubbles)\n", (unsigned long long)st.ops,
+           (unsigned long long)st.cycles, (unsigned long long)st.mode_switches, (unsigned long long)st.bubbles);
+    printf("Issue pattern %s: %.3f ops/cycle, pipeline latency %llu cycles, %llu valid_out timing errors\n",
+           issue_kind_name(opts.issue.kind), st.cycles ? (double)st.ops / st.cycles : 0.0,
+           (unsigned long long)sim.pipeline_latency(), (unsigned long long)st.latency_errors);
+    printf("Checked %llu results, %llu needed detailed checking\n",
+           (unsigned long long)checker.checked(), (unsigned long long)checker.slow_path());
+  } else if (opts.selection.test_mixed) {
+    printf("NOTE: mixed-mode tests only switch formats back to back with --stream\n");
+  }
+
+  if (opts.profile_eval) {
+    print_eval_profile(sim.eval_profile());
+  }
+
+  if (corpus.added() > 0) {
+    printf("%llu new failing vectors added to %s\n", (unsigned long long)corpus.added(), corpus.path().c_str());
+  }
+
+  // 5. 打印结果
+  if (result.failed > 0 || corpus_failed > 0) {
+    printf("\n=================================\n");
+    printf("      TEST FAILED!\n");
+    printf("=================================\n");
+    print_result_report(result);
+    if (corpus_failed > 0) {
+      printf("%lld failure corpus vectors still fail\n", (long long)corpus_failed);
     }
+    return 1; // 返回非零值表示失败
   }
 
-  // 5. 如果所有测试都通过，打印成功信息
   printf("\n=================================\n");
   printf("      ALL TESTS PASSED!\n");
   printf("=================================\n");
-  printf("Successfully completed %zu test cases.\n", tests.size());
+  printf("Successfully completed %llu test cases.\n", (unsigned long long)result.run);
   printf("=================================\n");
 
   return 0; // 返回0表示成功
-}
\ No newline at end of file
+}
+#endif // !FUZZ && !VFPU_LIB
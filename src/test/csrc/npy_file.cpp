@@ -0,0 +1,132 @@
+#include "include/npy_file.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+NpyArray::~NpyArray() {
+    if (map_) munmap(map_, map_size_);
+}
+
+// 从头部字典中取出 key 对应的值的原文，例如 'descr': '<f2' 得到 '<f2'
+static bool dict_value(const string& header, const char* key, string& value) {
+    string quoted = string("'") + key + "'";
+    size_t pos = header.find(quoted);
+    if (pos == string::npos) return false;
+    pos = header.find(':', pos + quoted.size());
+    if (pos == string::npos) return false;
+    pos = header.find_first_not_of(' ', pos + 1);
+    if (pos == string::npos) return false;
+    size_t end;
+    if (header[pos] == '\'') {
+        end = header.find('\'', pos + 1);
+        if (end == string::npos) return false;
+        value = header.substr(pos + 1, end - pos - 1);
+    } else if (header[pos] == '(') {
+        end = header.find(')', pos);
+        if (end == string::npos) return false;
+        value = header.substr(pos + 1, end - pos - 1);
+    } else {
+        end = header.find_first_of(",}", pos);
+        value = header.substr(pos, end == string::npos ? string::npos : end - pos);
+    }
+    return true;
+}
+
+bool NpyArray::open(const string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        printf("Cannot open %s\n", path.c_str());
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 10) {
+        close(fd);
+        printf("%s is not an .npy file\n", path.c_str());
+        return false;
+    }
+    map_size_ = (size_t)st.st_size;
+    map_ = mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        printf("Cannot map %s\n", path.c_str());
+        return false;
+    }
+    const uint8_t* p = (const uint8_t*)map_;
+    if (memcmp(p, "\x93NUMPY", 6) != 0) {
+        printf("%s is not an .npy file\n", path.c_str());
+        return false;
+    }
+    // 1.0 版头部长度为2字节，2.0/3.0 版为4字节
+    size_t header_len, header_pos;
+    if (p[6] == 1) {
+        header_len = p[8] | (p[9] << 8);
+        header_pos = 10;
+    } else {
+        if (map_size_ < 12) return false;
+        header_len = p[8] | (p[9] << 8) | (p[10] << 16) | ((size_t)p[11] << 24);
+        header_pos = 12;
+    }
+    if (header_pos + header_len > map_size_) {
+        printf("Truncated .npy header in %s\n", path.c_str());
+        return false;
+    }
+    string header((const char*)p + header_pos, header_len);
+
+    string order, shape;
+    if (!dict_value(header, "descr", descr_) || !dict_value(header, "fortran_order", order)
+        || !dict_value(header, "shape", shape)) {
+        printf("Malformed .npy header in %s\n", path.c_str());
+        return false;
+    }
+    if (order != "False") {
+        printf("%s: Fortran-ordered arrays are not supported\n", path.c_str());
+        return false;
+    }
+    if (descr_.size() < 3 || descr_[0] == '>') {
+        printf("%s: unsupported dtype %s (need little-endian)\n", path.c_str(), descr_.c_str());
+        return false;
+    }
+    item_size_ = (size_t)atoi(descr_.c_str() + 2);
+    if (item_size_ != 2 && item_size_ != 4) {
+        printf("%s: unsupported dtype %s (need 2- or 4-byte elements)\n", path.c_str(), descr_.c_str());
+        return false;
+    }
+
+    shape_.clear();
+    count_ = 1;
+    const char* s = shape.c_str();
+    while (*s) {
+        char* end;
+        unsigned long long dim = strtoull(s, &end, 10);
+        if (end == s) {
+            s++; // 跳过 ',' 与空格
+            continue;
+        }
+        if (dim > SIZE_MAX || (dim != 0 && count_ > SIZE_MAX / dim)) {
+            printf("%s: shape (%s) is too large\n", path.c_str(), shape.c_str());
+            return false;
+        }
+        shape_.push_back((size_t)dim);
+        count_ *= (size_t)dim;
+        s = end;
+    }
+
+    data_ = p + header_pos + header_len;
+    // 先除后比较，count_ * item_size_ 不会溢出
+    if (count_ > (map_size_ - (size_t)(data_ - p)) / item_size_) {
+        printf("%s: data is shorter than its shape\n", path.c_str());
+        return false;
+    }
+    // 顺序读取，提示内核预读
+    madvise(map_, map_size_, MADV_SEQUENTIAL);
+    return true;
+}
@@ -0,0 +1,471 @@
+#include "include/options.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+using namespace std;
+
+void print_usage(const char* prog) {
+    printf("Usage: %s [options] [verilator args]\n", prog);
+    printf("  --modes LIST           comma separated: fp32,fp16,bf16,fp16_widen,bf16_widen,mixed\n");
+    printf("                         (default: all = every mode except mixed)\n");
+    printf("  --count N              random vectors per random bucket (default: 200)\n");
+    printf("  --seed S               random seed (default: time)\n");
+    printf("  --shard I/N            run only tests whose index %% N == I\n");
+    printf("  --max-failures N       stop after N failures, 0 = never stop (default: 1)\n");
+    printf("  --stream               stream tests back to back, one per cycle\n");
+    printf("  --batch-size N         tests per streamed batch (default: 4096)\n");
+    printf("  --issue PATTERN        streamed valid_in pattern: full, bernoulli:P, burst:N:GAP,\n");
+    printf("                         periodic:K (default: full)\n");
+    printf("  --sequences N          run the tests from N concurrent coroutine sequences on one\n");
+    printf("                         clock loop (C++20 builds, not with --checkpoint or signatures)\n");
+    printf("  --sequence-window W    outstanding transactions per sequence (default: 4)\n");
+    printf("  --latency N            expected pipeline latency in cycles (default: measured)\n");
+    printf("  --threads N            VerilatedContext threads, at least the model's verilator\n");
+    printf("                         --threads (default: Verilator default)\n");
+    printf("  --autotune [FILE]      benchmark 1..cores/threads independent model instances,\n");
+    printf("                         append results to FILE and pick the best split across\n");
+    printf("                         every build recorded in it\n");
+    printf("  --autotune-ops N       vectors run per configuration (default: 200000)\n");
+    printf("  --autotune-cores N     cores available to the split (default: all)\n");
+    printf("  --serve SOCKET         keep warm model instances and run batches submitted over a\n");
+    printf("                         Unix socket with shared-memory operands (see sim_server.h)\n");
+    printf("  --serve-instances N    model instances kept by --serve (default: 1)\n");
+    printf("  --npy-add A B          add two memory-mapped .npy tensors element-wise through\n");
+    printf("                         the model and report error vs FP64 and elements/sec\n");
+    printf("  --npy-sum A            sum each row (last axis) of an .npy tensor by a pairwise\n");
+    printf("                         tree of model adds and report error vs FP64\n");
+    printf("  --npy-format F         tensor format fp32, fp16 or bf16 (default: from dtype,\n");
+    printf("                         2-byte dtypes other than <f2 are read as bf16 bits)\n");
+    printf("  --npy-widen            use the widen modes for 16-bit tensors (FP32 results)\n");
+    printf("  --conversion-sweep     check fp_utils conversions against SoftFloat and an RNE\n");
+    printf("                         BF16 reference over every 16-bit and 32-bit input and exit\n");
+    printf("  --sweep-threads N      threads used by the sweep (default: all cores)\n");
+    printf("  --sweep-step N         test every Nth FP32 input (default: 1, exhaustive)\n");
+    printf("  --adaptive             allocate random vectors across buckets by coverage yield and\n");
+    printf("                         stop each bucket at a confidence bound on its failure rate\n");
+    printf("  --confidence C         confidence of the adaptive stopping bound (default: 0.95)\n");
+    printf("  --max-fail-rate P      failure rate bound each bucket must reach (default: 0.02)\n");
+    printf("  --budget N             adaptive random vector budget (default: 4x the fixed\n");
+    printf("                         allocation --count gives the selected buckets)\n");
+    printf("  --record-signature FILE\n");
+    printf("                         stream the shard and record a rolling hash of all outputs\n");
+    printf("  --signature FILE       stream the shard without computing reference results and\n");
+    printf("                         compare the output hash, locating the first diverging block\n");
+    printf("  --signature-block N    outputs between stored prefix hashes (default: 4096)\n");
+    printf("  --result FILE          write this shard's result file\n");
+    printf("  --checkpoint FILE      periodically write a checkpoint\n");
+    printf("  --checkpoint-every N   tests between checkpoints (default: 1000)\n");
+    printf("  --restore FILE         resume from a checkpoint\n");
+    printf("  --pack FILE            run the vectors of a vector pack instead of --modes/--count\n");
+    printf("  --record-stimulus FILE record every input driven into the model, cycle by cycle\n");
+    printf("  --replay-stimulus FILE drive a recorded stimulus trace into this build, compare\n");
+    printf("                         valid_out and results with the recording and exit\n");
+    printf("  --corpus FILE          failure corpus replayed before any other test and extended\n");
+    printf("                         with every new failing vector (default: failure_corpus.txt)\n");
+    printf("  --no-corpus            neither replay nor record the failure corpus\n");
+    printf("  --minimize FILE        run the selected suite once, write the smallest subset with\n");
+    printf("                         the same functional/RTL coverage as a vector pack and exit\n");
+    printf("  --merge FILE...        merge shard result files into one report and exit\n");
+    printf("  --coverage FILE        coverage database written at exit (COVERAGE builds,\n");
+    printf("                         default: coverage.dat or coverage_I_N.dat per shard)\n");
+    printf("  --coverage-merge FILE...\n");
+    printf("                         merge coverage databases, report uncovered lines and\n");
+    printf("                         toggles per module and exit (--coverage names the output)\n");
+    printf("  --trace FILE           Chrome/Perfetto trace output (PERF_TRACE builds,\n");
+    printf("                         default: perf_trace.json)\n");
+    printf("  --wave FILE            waveform output (VCD/FST builds, default: build/vfpu/top.vcd\n");
+    printf("                         or build/vfpu/top.fst)\n");
+    printf("  --wave-scope LIST      trace only these comma separated scopes and everything\n");
+    printf("                         below them, e.g. TOP.top.fadd (default: whole design)\n");
+    printf("  --wave-depth N         hierarchy levels traced from the top and from each\n");
+    printf("                         --wave-scope, 1 to 99 (default: 99)\n");
+    printf("  --wave-cycles A:B      write the waveform only for cycles A..B-1 (A: or :B open)\n");
+    printf("  --activity PREFIX      count toggles of the selected signals per stimulus source\n");
+    printf("                         and mode, write PREFIX.saif and PREFIX.<source>.<mode>.saif\n");
+    printf("  --activity-signals LIST\n");
+    printf("                         comma separated top ports and TOP.top.<scope>.<signal> names\n");
+    printf("                         (internal signals need -DACTIVITY_SCOPES, default: all ports)\n");
+    printf("  --activity-period NS   clock period used for SAIF durations (default: 1)\n");
+    printf("  --profile-eval         time every Vtop::eval() and report eval time per mode\n");
+    printf("  --prof-report [MODE=]FILE...\n");
+    printf("                         rank RTL modules and source lines by self time in gprof\n");
+    printf("                         flat profiles of a verilator --prof-cfuncs build and exit\n");
+    printf("  +verilator+prof+exec+* forwarded to Verilator (verilator --prof-exec builds)\n");
+    printf("  --help                 show this message\n");
+}
+
+static bool parse_uint64(const char* s, uint64_t& v) {
+    char* end = nullptr;
+    v = strtoull(s, &end, 0);
+    return end != s && *end == '\0';
+}
+
+static bool parse_double(const char* s, double& v) {
+    char* end = nullptr;
+    v = strtod(s, &end);
+    return end != s && *end == '\0';
+}
+
+// A:B、A: 或 :B，省略的一端不限 (0)
+static bool parse_cycle_window(const char* s, uint64_t& begin, uint64_t& end) {
+    const char* colon = strchr(s, ':');
+    if (!colon) return false;
+    string first(s, colon - s), second(colon + 1);
+    begin = end = 0;
+    if (!first.empty() && !parse_uint64(first.c_str(), begin)) return false;
+    if (!second.empty() && !parse_uint64(second.c_str(), end)) return false;
+    return !end || begin < end;
+}
+
+static bool parse_modes(const string& list, TestSelection& sel) {
+    sel.test_fp32 = sel.test_fp16 = sel.test_bf16 = false;
+    sel.test_fp16_widen = sel.test_bf16_widen = false;
+    sel.test_mixed = false;
+    stringstream ss(list);
+    string mode;
+    while (getline(ss, mode, ',')) {
+        if (mode == "fp32") sel.test_fp32 = true;
+        else if (mode == "fp16") sel.test_fp16 = true;
+        else if (mode == "bf16") sel.test_bf16 = true;
+        else if (mode == "fp16_widen") sel.test_fp16_widen = true;
+        else if (mode == "bf16_widen") sel.test_bf16_widen = true;
+        else if (mode == "mixed") sel.test_mixed = true;
+        else if (mode == "all") {
+            sel.test_fp32 = sel.test_fp16 = sel.test_bf16 = true;
+            sel.test_fp16_widen = sel.test_bf16_widen = true;
+        } else {
+            printf("Unknown mode: %s\n", mode.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parse_options(int argc, char* argv[], SimOptions& opts) {
+    opts.verilator_args.push_back(argv[0]);
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        // 需要一个参数值的选项
+        auto value = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                printf("Option %s requires a value\n", name);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        // 需要一个整数参数值的选项
+        auto uint_value = [&](const char* name, uint64_t& out) -> bool {
+            const char* s = value(name);
+            if (!s) return false;
+            if (!parse_uint64(s, out)) {
+                printf("Invalid value for %s: %s\n", name, s);
+                return false;
+            }
+            return true;
+        };
+        // 需要一个 (0, 1) 之间的概率值的选项
+        auto prob_value = [&](const char* name, double& out) -> bool {
+            const char* s = value(name);
+            if (!s) return false;
+            if (!parse_double(s, out) || !(out > 0.0 && out < 1.0)) {
+                printf("Invalid value for %s: %s, expected 0 < value < 1\n", name, s);
+                return false;
+            }
+            return true;
+        };
+        uint64_t v = 0;
+
+        if (!strcmp(arg, "--help") || !strcmp(arg, "-h")) {
+            opts.show_help = true;
+        } else if (!strcmp(arg, "--modes")) {
+            const char* s = value(arg);
+            if (!s || !parse_modes(s, opts.selection)) return false;
+        } else if (!strcmp(arg, "--count")) {
+            if (!uint_value(arg, v)) return false;
+            if (v > INT_MAX) {
+                printf("Invalid value for --count: %llu\n", (unsigned long long)v);
+                return false;
+            }
+            opts.selection.num_random_tests = (int)v;
+        } else if (!strcmp(arg, "--seed")) {
+            if (!uint_value(arg, v)) return false;
+            if (v > UINT32_MAX) {
+                printf("Invalid value for --seed: %llu\n", (unsigned long long)v);
+                return false;
+            }
+            opts.seed = (uint32_t)v;
+            opts.seed_set = true;
+        } else if (!strcmp(arg, "--shard")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            // 整个参数必须恰好是 I/N
+            uint64_t index = 0, count = 0;
+            const char* slash = strchr(s, '/');
+            if (!slash || !parse_uint64(string(s, slash - s).c_str(), index) || !parse_uint64(slash + 1, count)
+                || count == 0 || count > UINT_MAX || index >= count) {
+                printf("Invalid shard, expected I/N with 0 <= I < N\n");
+                return false;
+            }
+            opts.shard_index = (unsigned)index;
+            opts.shard_count = (unsigned)count;
+        } else if (!strcmp(arg, "--max-failures")) {
+            if (!uint_value(arg, opts.max_failures)) return false;
+        } else if (!strcmp(arg, "--stream")) {
+            opts.stream = true;
+        } else if (!strcmp(arg, "--batch-size")) {
+            if (!uint_value(arg, opts.batch_size)) return false;
+            if (opts.batch_size == 0) {
+                printf("Option --batch-size must be positive\n");
+                return false;
+            }
+        } else if (!strcmp(arg, "--issue")) {
+            const char* s = value(arg);
+            if (!s || !parse_issue_pattern(s, opts.issue)) return false;
+        } else if (!strcmp(arg, "--latency")) {
+            if (!uint_value(arg, opts.latency)) return false;
+        } else if (!strcmp(arg, "--threads")) {
+            if (!uint_value(arg, v)) return false;
+            if (v != (unsigned)v) {
+                printf("Invalid value for --threads: %llu\n", (unsigned long long)v);
+                return false;
+            }
+            opts.threads = (unsigned)v;
+        } else if (!strcmp(arg, "--autotune")) {
+            opts.autotune = true;
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0 && argv[i + 1][0] != '+') {
+                opts.autotune_path = argv[++i];
+            }
+        } else if (!strcmp(arg, "--autotune-ops")) {
+            if (!uint_value(arg, opts.autotune_ops)) return false;
+            if (opts.autotune_ops == 0) {
+                printf("Option --autotune-ops must be positive\n");
+                return false;
+            }
+        } else if (!strcmp(arg, "--autotune-cores")) {
+            if (!uint_value(arg, v)) return false;
+            if (v != (unsigned)v) {
+                printf("Invalid value for --autotune-cores: %llu\n", (unsigned long long)v);
+                return false;
+            }
+            opts.autotune_cores = (unsigned)v;
+        } else if (!strcmp(arg, "--serve")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.serve_path = s;
+        } else if (!strcmp(arg, "--serve-instances")) {
+            if (!uint_value(arg, v)) return false;
+            if (v != (unsigned)v) {
+                printf("Invalid value for --serve-instances: %llu\n", (unsigned long long)v);
+                return false;
+            }
+            if (v == 0) {
+                printf("Option --serve-instances must be positive\n");
+                return false;
+            }
+            opts.serve_instances = (unsigned)v;
+        } else if (!strcmp(arg, "--npy-add") || !strcmp(arg, "--npy-sum")) {
+            size_t need = !strcmp(arg, "--npy-add") ? 2 : 1;
+            opts.npy_inputs.clear();
+            while (opts.npy_inputs.size() < need) {
+                const char* s = value(arg);
+                if (!s) return false;
+                opts.npy_inputs.push_back(s);
+            }
+        } else if (!strcmp(arg, "--npy-format")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.npy_format = s;
+        } else if (!strcmp(arg, "--npy-widen")) {
+            opts.npy_widen = true;
+        } else if (!strcmp(arg, "--sequences")) {
+            if (!uint_value(arg, v)) return false;
+            if (v != (unsigned)v) {
+                printf("Invalid value for --sequences: %llu\n", (unsigned long long)v);
+                return false;
+            }
+            opts.sequences = (unsigned)v;
+        } else if (!strcmp(arg, "--sequence-window")) {
+            if (!uint_value(arg, v)) return false;
+            if (v != (unsigned)v) {
+                printf("Invalid value for --sequence-window: %llu\n", (unsigned long long)v);
+                return false;
+            }
+            if (v == 0) {
+                printf("Option --sequence-window must be positive\n");
+                return false;
+            }
+            opts.sequence_window = (unsigned)v;
+        } else if (!strcmp(arg, "--conversion-sweep")) {
+            opts.conversion_sweep = true;
+        } else if (!strcmp(arg, "--sweep-threads")) {
+            if (!uint_value(arg, v)) return false;
+            if (v != (unsigned)v) {
+                printf("Invalid value for --sweep-threads: %llu\n", (unsigned long long)v);
+                return false;
+            }
+            opts.sweep_threads = (unsigned)v;
+        } else if (!strcmp(arg, "--sweep-step")) {
+            if (!uint_value(arg, opts.sweep_step)) return false;
+            if (opts.sweep_step == 0) {
+                printf("Option --sweep-step must be positive\n");
+                return false;
+            }
+        } else if (!strcmp(arg, "--adaptive")) {
+            opts.adaptive = true;
+        } else if (!strcmp(arg, "--confidence")) {
+            if (!prob_value(arg, opts.confidence)) return false;
+        } else if (!strcmp(arg, "--max-fail-rate")) {
+            if (!prob_value(arg, opts.max_fail_rate)) return false;
+        } else if (!strcmp(arg, "--budget")) {
+            if (!uint_value(arg, opts.budget)) return false;
+        } else if (!strcmp(arg, "--signature")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.signature_path = s;
+        } else if (!strcmp(arg, "--record-signature")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.record_signature_path = s;
+        } else if (!strcmp(arg, "--signature-block")) {
+            if (!uint_value(arg, opts.signature_block)) return false;
+            if (opts.signature_block == 0) {
+                printf("Option --signature-block must be positive\n");
+                return false;
+            }
+        } else if (!strcmp(arg, "--result")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.result_path = s;
+        } else if (!strcmp(arg, "--checkpoint")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.checkpoint_path = s;
+        } else if (!strcmp(arg, "--checkpoint-every")) {
+            if (!uint_value(arg, opts.checkpoint_every)) return false;
+        } else if (!strcmp(arg, "--restore")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.restore_path = s;
+        } else if (!strcmp(arg, "--pack")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.pack_path = s;
+        } else if (!strcmp(arg, "--record-stimulus")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.record_stimulus_path = s;
+        } else if (!strcmp(arg, "--replay-stimulus")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.replay_stimulus_path = s;
+        } else if (!strcmp(arg, "--corpus")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.corpus_path = s;
+        } else if (!strcmp(arg, "--no-corpus")) {
+            opts.corpus_path.clear();
+        } else if (!strcmp(arg, "--minimize")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.minimize_path = s;
+        } else if (!strcmp(arg, "--merge")) {
+            // --merge 之后直到下一个 -- 选项之前的参数都是输入文件
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+                opts.merge_inputs.push_back(argv[++i]);
+            }
+            if (opts.merge_inputs.empty()) {
+                printf("Option --merge requires at least one result file\n");
+                return false;
+            }
+        } else if (!strcmp(arg, "--coverage")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.coverage_path = s;
+        } else if (!strcmp(arg, "--coverage-merge")) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+                opts.coverage_inputs.push_back(argv[++i]);
+            }
+            if (opts.coverage_inputs.empty()) {
+                printf("Option --coverage-merge requires at least one coverage file\n");
+                return false;
+            }
+        } else if (!strcmp(arg, "--trace")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.trace_path = s;
+        } else if (!strcmp(arg, "--wave")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.wave.path = s;
+        } else if (!strcmp(arg, "--wave-depth")) {
+            uint64_t depth;
+            if (!uint_value(arg, depth)) return false;
+            // 0 在 Verilator 的 dumpvars 中表示不限制，不作为层数接受
+            if (depth == 0 || depth > 99) {
+                printf("Invalid value for --wave-depth: %llu, expected 1 to 99\n", (unsigned long long)depth);
+                return false;
+            }
+            opts.wave.depth = (int)depth;
+        } else if (!strcmp(arg, "--wave-scope")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            stringstream ss(s);
+            string scope;
+            while (getline(ss, scope, ',')) {
+                if (!scope.empty()) opts.wave.scopes.push_back(scope);
+            }
+        } else if (!strcmp(arg, "--wave-cycles")) {
+            const char* s = value(arg);
+            if (!s || !parse_cycle_window(s, opts.wave.begin_cycle, opts.wave.end_cycle)) {
+                printf("Invalid cycle window, expected A:B, A: or :B with A < B\n");
+                return false;
+            }
+        } else if (!strcmp(arg, "--activity")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            opts.activity.prefix = s;
+        } else if (!strcmp(arg, "--activity-signals")) {
+            const char* s = value(arg);
+            if (!s) return false;
+            stringstream ss(s);
+            string name;
+            while (getline(ss, name, ',')) {
+                if (!name.empty()) opts.activity.signals.push_back(name);
+            }
+        } else if (!strcmp(arg, "--activity-period")) {
+            const char* s = value(arg);
+            if (!s || !parse_double(s, opts.activity.period_ns) || opts.activity.period_ns <= 0) {
+                printf("Option --activity-period expects a positive clock period in ns\n");
+                return false;
+            }
+        } else if (!strcmp(arg, "--profile-eval")) {
+            opts.profile_eval = true;
+        } else if (!strcmp(arg, "--prof-report")) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+                opts.prof_inputs.push_back(argv[++i]);
+            }
+            if (opts.prof_inputs.empty()) {
+                printf("Option --prof-report requires at least one gprof report\n");
+                return false;
+            }
+        } else if (!strncmp(arg, "--", 2)) {
+            printf("Unknown option: %s\n", arg);
+            return false;
+        } else {
+            opts.verilator_args.push_back(argv[i]);
+        }
+    }
+    // 并发序列的事务跨周期交错，无法在两个向量之间写检查点; 签名按发射顺序计算，不经过序列
+    if (opts.sequences && (!opts.checkpoint_path.empty() || !opts.signature_path.empty()
+                           || !opts.record_signature_path.empty())) {
+        printf("Option --sequences cannot be combined with --checkpoint, --signature or --record-signature\n");
+        return false;
+    }
+    return true;
+}
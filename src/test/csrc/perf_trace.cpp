@@ -0,0 +1,169 @@
+#ifdef PERF_TRACE
+
+#include "include/perf_trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const size_t kTraceRingSize = 1 << 18; // 每个线程保留的最近事件数
+
+struct TraceEvent {
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+};
+
+// 热点作用域按名称的汇总
+struct HotStat {
+    const char* name;
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+};
+
+// 单个线程的环形缓冲区与热点汇总，只由所属线程写入;
+// 写入期间 busy 为 true，导出时等待其变为 false
+struct TraceRing {
+    unsigned tid;
+    atomic<bool> busy{false};
+    uint64_t written = 0;
+    vector<TraceEvent> events;
+    vector<HotStat> hot;
+
+    explicit TraceRing(unsigned id) : tid(id), events(kTraceRingSize) {}
+};
+
+static mutex rings_lock;
+static vector<unique_ptr<TraceRing>> rings; // 进程退出前不释放，导出时线程可能已结束
+static atomic<bool> trace_stopped(false);
+static string output_path;
+
+static const chrono::steady_clock::time_point trace_epoch = chrono::steady_clock::now();
+
+static uint64_t now_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - trace_epoch).count();
+}
+
+static TraceRing* this_thread_ring() {
+    thread_local TraceRing* ring = nullptr;
+    if (!ring) {
+        lock_guard<mutex> guard(rings_lock);
+        rings.emplace_back(new TraceRing((unsigned)rings.size() + 1));
+        ring = rings.back().get();
+    }
+    return ring;
+}
+
+ScopedTrace::ScopedTrace(const char* name, bool hot) : name_(name), hot_(hot), begin_ns_(now_ns()) {}
+
+ScopedTrace::~ScopedTrace() {
+    uint64_t end_ns = now_ns();
+    TraceRing* ring = this_thread_ring();
+    // 与 write_chrome_trace 配对: 先置 busy 再检查 trace_stopped (均为 seq_cst)，
+    // 导出方先置 trace_stopped 再等待 busy，两者不会同时访问缓冲区
+    ring->busy.store(true);
+    if (!trace_stopped.load()) {
+        if (hot_) {
+            auto it = find_if(ring->hot.begin(), ring->hot.end(), [&](const HotStat& s) { return s.name == name_; });
+            if (it == ring->hot.end()) {
+                ring->hot.push_back(HotStat{name_});
+                it = ring->hot.end() - 1;
+            }
+            uint64_t ns = end_ns - begin_ns_;
+            it->count++;
+            it->total_ns += ns;
+            it->max_ns = max(it->max_ns, ns);
+        } else {
+            TraceEvent& e = ring->events[ring->written++ % kTraceRingSize];
+            e.name = name_;
+            e.begin_ns = begin_ns_;
+            e.end_ns = end_ns;
+        }
+    }
+    ring->busy.store(false, memory_order_release);
+}
+
+bool write_chrome_trace(const string& path) {
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp) {
+        printf("Cannot open trace file %s\n", path.c_str());
+        return false;
+    }
+    trace_stopped = true;
+    lock_guard<mutex> guard(rings_lock);
+    for (const auto& ring : rings) {
+        while (ring->busy.load(memory_order_acquire)) {
+            this_thread::yield();
+        }
+    }
+
+    uint64_t dropped = 0;
+    bool first = true;
+    map<string, HotStat> hot; // 所有线程按名称合并
+    fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for (const auto& ring : rings) {
+        uint64_t count = ring->written < kTraceRingSize ? ring->written : kTraceRingSize;
+        dropped += ring->written - count;
+        // 环形缓冲区中最早的事件在 written % size 处
+        for (uint64_t k = ring->written - count; k < ring->written; ++k) {
+            const TraceEvent& e = ring->events[k % kTraceRingSize];
+            fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    first ? "" : ",\n", e.name, ring->tid, e.begin_ns / 1000.0,
+                    (e.end_ns - e.begin_ns) / 1000.0);
+            first = false;
+        }
+        for (const HotStat& s : ring->hot) {
+            HotStat& h = hot.emplace(s.name, HotStat{s.name}).first->second;
+            h.count += s.count;
+            h.total_ns += s.total_ns;
+            h.max_ns = max(h.max_ns, s.max_ns);
+        }
+    }
+    fprintf(fp, "\n],\"otherData\":{");
+    first = true;
+    for (const auto& kv : hot) {
+        const HotStat& h = kv.second;
+        fprintf(fp, "%s\n\"%s\":\"calls=%llu total_ms=%.3f max_us=%.3f\"", first ? "" : ",", h.name,
+                (unsigned long long)h.count, h.total_ns / 1e6, h.max_ns / 1000.0);
+        first = false;
+    }
+    fprintf(fp, "\n}}\n");
+    bool ok = fclose(fp) == 0;
+
+    if (!hot.empty()) {
+        printf("Hot scopes (aggregated, not in the timeline):\n");
+        printf("  %-32s %12s %12s %10s %10s\n", "scope", "calls", "total ms", "avg ns", "max us");
+        for (const auto& kv : hot) {
+            const HotStat& h = kv.second;
+            printf("  %-32s %12llu %12.3f %10.0f %10.3f\n", h.name, (unsigned long long)h.count, h.total_ns / 1e6,
+                   h.count ? (double)h.total_ns / h.count : 0.0, h.max_ns / 1000.0);
+        }
+    }
+    printf("Trace written to %s", path.c_str());
+    if (dropped) printf(" (%llu oldest events dropped)", (unsigned long long)dropped);
+    printf("\n");
+    return ok;
+}
+
+static void write_trace_at_exit() {
+    write_chrome_trace(output_path);
+}
+
+void set_trace_output(const string& path) {
+    if (output_path.empty()) {
+        atexit(write_trace_at_exit);
+    }
+    output_path = path;
+}
+
+#endif // PERF_TRACE
@@ -0,0 +1,178 @@
+#include "include/result_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+const int kResultFileVersion = 1;
+
+bool write_result_file(const string& path, const ShardResult& r) {
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp) {
+        printf("Cannot open result file %s\n", path.c_str());
+        return false;
+    }
+    fprintf(fp, "# vfpu simulation result\n");
+    fprintf(fp, "version %d\n", kResultFileVersion);
+    fprintf(fp, "seed %u\n", r.seed);
+    if (r.merged) {
+        fprintf(fp, "shard all %u\n", r.shard_count);
+    } else {
+        fprintf(fp, "shard %u %u\n", r.shard_index, r.shard_count);
+    }
+    fprintf(fp, "modes %s\n", r.modes.c_str());
+    fprintf(fp, "count %d\n", r.num_random_tests);
+    fprintf(fp, "total %llu\n", (unsigned long long)r.total);
+    fprintf(fp, "run %llu\n", (unsigned long long)r.run);
+    fprintf(fp, "passed %llu\n", (unsigned long long)r.passed);
+    fprintf(fp, "failed %llu\n", (unsigned long long)r.failed);
+    for (const FailureRecord& f : r.failures) {
+        fprintf(fp, "fail %llu %s\n", (unsigned long long)f.index, test_mode_name(f.mode));
+    }
+    return fclose(fp) == 0;
+}
+
+bool read_result_file(const string& path, ShardResult& r) {
+    ifstream in(path);
+    if (!in) {
+        printf("Cannot open result file %s\n", path.c_str());
+        return false;
+    }
+    r = ShardResult();
+    string line;
+    int version = 0;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream ss(line);
+        string key;
+        ss >> key;
+        bool ok = true;
+        if (key == "version") {
+            ok = (bool)(ss >> version);
+        } else if (key == "seed") {
+            ok = (bool)(ss >> r.seed);
+        } else if (key == "shard") {
+            string index;
+            ok = (bool)(ss >> index >> r.shard_count);
+            r.merged = (index == "all");
+            if (ok && !r.merged) {
+                char* end = nullptr;
+                unsigned long v = strtoul(index.c_str(), &end, 10);
+                ok = end != index.c_str() && *end == '\0' && v < r.shard_count;
+                r.shard_index = (unsigned)v;
+            }
+            ok = ok && r.shard_count > 0;
+        } else if (key == "modes") {
+            ok = (bool)(ss >> r.modes);
+        } else if (key == "count") {
+            ok = (bool)(ss >> r.num_random_tests);
+        } else if (key == "total") {
+            ok = (bool)(ss >> r.total);
+        } else if (key == "run") {
+            ok = (bool)(ss >> r.run);
+        } else if (key == "passed") {
+            ok = (bool)(ss >> r.passed);
+        } else if (key == "failed") {
+            ok = (bool)(ss >> r.failed);
+        } else if (key == "fail") {
+            FailureRecord f;
+            string mode;
+            ok = (bool)(ss >> f.index >> mode) && parse_test_mode(mode.c_str(), f.mode);
+            if (ok) r.failures.push_back(f);
+        }
+        if (!ok) {
+            printf("Malformed line in %s: %s\n", path.c_str(), line.c_str());
+            return false;
+        }
+    }
+    if (version != kResultFileVersion) {
+        printf("Unsupported result file version in %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool merge_results(const vector<ShardResult>& shards, ShardResult& merged) {
+    if (shards.empty()) return false;
+    const ShardResult& first = shards[0];
+    merged = ShardResult();
+    merged.seed = first.seed;
+    merged.shard_count = first.shard_count;
+    merged.merged = true;
+    merged.modes = first.modes;
+    merged.num_random_tests = first.num_random_tests;
+
+    // 所有分片的 shard_count 必须一致，shard_index 在范围内 (read_result_file 已检查，这里不依赖调用方)
+    vector<bool> seen(first.shard_count, false);
+    for (const ShardResult& r : shards) {
+        if (r.merged || r.seed != first.seed || r.shard_count != first.shard_count
+            || r.modes != first.modes || r.num_random_tests != first.num_random_tests) {
+            printf("Shard %u/%u does not belong to the same campaign\n", r.shard_index, r.shard_count);
+            return false;
+        }
+        if (r.shard_count == 0 || r.shard_index >= r.shard_count) {
+            printf("Invalid shard %u/%u\n", r.shard_index, r.shard_count);
+            return false;
+        }
+        if (seen[r.shard_index]) {
+            printf("Shard %u/%u appears more than once\n", r.shard_index, r.shard_count);
+            return false;
+        }
+        seen[r.shard_index] = true;
+        merged.total += r.total;
+        merged.run += r.run;
+        merged.passed += r.passed;
+        merged.failed += r.failed;
+        merged.failures.insert(merged.failures.end(), r.failures.begin(), r.failures.end());
+    }
+    for (unsigned i = 0; i < first.shard_count; ++i) {
+        if (!seen[i]) {
+            printf("WARNING: shard %u/%u is missing, report is incomplete\n", i, first.shard_count);
+        }
+    }
+    sort(merged.failures.begin(), merged.failures.end(),
+         [](const FailureRecord& a, const FailureRecord& b) { return a.index < b.index; });
+    return true;
+}
+
+void print_result_report(const ShardResult& r) {
+    printf("\n=================================\n");
+    if (r.merged) {
+        printf("  Campaign report (%u shards)\n", r.shard_count);
+    } else {
+        printf("  Shard %u/%u report\n", r.shard_index, r.shard_count);
+    }
+    printf("=================================\n");
+    printf("Seed:    %u\n", r.seed);
+    printf("Modes:   %s (count %d)\n", r.modes.c_str(), r.num_random_tests);
+    printf("Tests:   %llu run of %llu\n", (unsigned long long)r.run, (unsigned long long)r.total);
+    printf("Passed:  %llu\n", (unsigned long long)r.passed);
+    printf("Failed:  %llu\n", (unsigned long long)r.failed);
+    for (const FailureRecord& f : r.failures) {
+        printf("  FAIL test case %llu (%s)\n", (unsigned long long)f.index + 1, test_mode_name(f.mode));
+    }
+    printf("=================================\n");
+}
+
+int merge_result_files(const vector<string>& inputs, const string& output_path) {
+    vector<ShardResult> shards(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!read_result_file(inputs[i], shards[i])) {
+            return 1;
+        }
+    }
+    ShardResult merged;
+    if (!merge_results(shards, merged)) {
+        return 1;
+    }
+    print_result_report(merged);
+    if (!output_path.empty() && !write_result_file(output_path, merged)) {
+        return 1;
+    }
+    return (merged.failed == 0 && merged.run == merged.total) ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+#include "include/rtl_profile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+using namespace std;
+
+static const char* const kVtopOther = "(Vtop other)";
+static const char* const kHarness = "(harness)";
+
+void print_eval_profile(const EvalProfile& prof) {
+    printf("\n=================================\n");
+    printf("  Vtop::eval() profile by mode\n");
+    printf("=================================\n");
+    printf("  %-12s %12s %12s %12s %10s %10s\n", "mode", "ops", "cycles", "eval ms", "ns/cycle", "ns/op");
+    uint64_t total_ns = 0;
+    for (int m = 0; m < kNumTestModes; ++m) {
+        total_ns += prof.eval_ns[m];
+    }
+    for (int m = 0; m < kNumTestModes; ++m) {
+        if (!prof.cycles[m]) continue;
+        printf("  %-12s %12llu %12llu %12.3f %10.1f %10.1f  (%.1f%%)\n", test_mode_name((TestMode)m),
+               (unsigned long long)prof.ops[m], (unsigned long long)prof.cycles[m], prof.eval_ns[m] / 1e6,
+               (double)prof.eval_ns[m] / prof.cycles[m], prof.ops[m] ? (double)prof.eval_ns[m] / prof.ops[m] : 0.0,
+               total_ns ? 100.0 * prof.eval_ns[m] / total_ns : 0.0);
+    }
+    printf("=================================\n");
+}
+
+// --prof-cfuncs 生成的函数名: ..._PROF__<模块>__l<行号>(参数)
+static void classify_function(const string& name, RtlProfileEntry& e) {
+    e.function = name;
+    e.line = 0;
+    size_t pos = name.find("__PROF__");
+    if (pos != string::npos) {
+        size_t begin = pos + strlen("__PROF__");
+        size_t end = name.find('(', begin);
+        string tail = name.substr(begin, end == string::npos ? string::npos : end - begin);
+        size_t l = tail.rfind("__l");
+        if (l != string::npos && l + 3 < tail.size() && isdigit((unsigned char)tail[l + 3])) {
+            e.module = tail.substr(0, l);
+            e.line = atoi(tail.c_str() + l + 3);
+            return;
+        }
+        e.module = tail;
+        return;
+    }
+    if (name.find("Vtop") != string::npos || name.find("Verilated") != string::npos
+        || name.find("verilated") != string::npos) {
+        e.module = kVtopOther;
+    } else {
+        e.module = kHarness;
+    }
+}
+
+bool read_gprof_flat(const string& path, vector<RtlProfileEntry>& entries) {
+    ifstream in(path);
+    if (!in) {
+        printf("Cannot open profile %s\n", path.c_str());
+        return false;
+    }
+    string line;
+    bool in_table = false;
+    while (getline(in, line)) {
+        if (!in_table) {
+            // 表头: " time   seconds   seconds    calls  ms/call  ms/call  name"
+            if (line.find("time") != string::npos && line.find("name") != string::npos) {
+                in_table = true;
+            }
+            continue;
+        }
+        if (line.empty() || line.find("Call graph") != string::npos || line[0] == '\f') {
+            break; // 平面报告结束
+        }
+        // 行格式: %time cumulative self [calls self/call total/call] name
+        istringstream ss(line);
+        vector<double> numbers;
+        string token;
+        while (numbers.size() < 6) {
+            streampos before = ss.tellg();
+            if (!(ss >> token)) break;
+            char* end = nullptr;
+            double v = strtod(token.c_str(), &end);
+            if (end == token.c_str() || *end != '\0') {
+                ss.clear();
+                ss.seekg(before);
+                break;
+            }
+            numbers.push_back(v);
+        }
+        streampos name_pos = ss.tellg();
+        if (numbers.size() < 3 || name_pos < 0) continue;
+        string name = line.substr((size_t)name_pos);
+        size_t first = name.find_first_not_of(" \t");
+        if (first == string::npos) continue;
+        RtlProfileEntry e;
+        e.self_seconds = numbers[2];
+        classify_function(name.substr(first), e);
+        entries.push_back(e);
+    }
+    if (!in_table) {
+        printf("No gprof flat profile found in %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+struct ModuleTime {
+    double seconds = 0;
+    map<int, double> lines; // 行号 -> self time
+};
+
+static bool by_seconds_desc(const pair<string, double>& a, const pair<string, double>& b) {
+    return a.second > b.second;
+}
+
+int rtl_profile_report(const vector<string>& inputs, size_t max_lines) {
+    vector<string> labels;
+    vector<map<string, ModuleTime>> per_label;
+    vector<double> label_total;
+    for (const string& input : inputs) {
+        size_t eq = input.find('=');
+        string label = eq == string::npos ? input : input.substr(0, eq);
+        string path = eq == string::npos ? input : input.substr(eq + 1);
+        vector<RtlProfileEntry> entries;
+        if (!read_gprof_flat(path, entries)) {
+            return 1;
+        }
+        map<string, ModuleTime> modules;
+        double total = 0;
+        for (const RtlProfileEntry& e : entries) {
+            ModuleTime& mt = modules[e.module];
+            mt.seconds += e.self_seconds;
+            if (e.line) mt.lines[e.line] += e.self_seconds;
+            total += e.self_seconds;
+        }
+        labels.push_back(label);
+        per_label.push_back(modules);
+        label_total.push_back(total);
+    }
+
+    // 每个报告: 模块按 self time 排序，RTL 模块列出最热的源代码行
+    for (size_t k = 0; k < labels.size(); ++k) {
+        printf("\n=================================\n");
+        printf("  RTL profile: %s (%.2f s sampled)\n", labels[k].c_str(), label_total[k]);
+        printf("=================================\n");
+        vector<pair<string, double>> ranked;
+        for (const auto& kv : per_label[k]) {
+            ranked.push_back(make_pair(kv.first, kv.second.seconds));
+        }
+        sort(ranked.begin(), ranked.end(), by_seconds_desc);
+        for (const auto& r : ranked) {
+            printf("  %-28s %10.3f s  %5.1f%%\n", r.first.c_str(), r.second,
+                   label_total[k] > 0 ? 100.0 * r.second / label_total[k] : 0.0);
+            const map<int, double>& lines = per_label[k][r.first].lines;
+            vector<pair<int, double>> hot(lines.begin(), lines.end());
+            sort(hot.begin(), hot.end(),
+                 [](const pair<int, double>& a, const pair<int, double>& b) { return a.second > b.second; });
+            for (size_t i = 0; i < hot.size() && (max_lines == 0 || i < max_lines); ++i) {
+                printf("      line %-8d %10.3f s  %5.1f%%\n", hot[i].first, hot[i].second,
+                       label_total[k] > 0 ? 100.0 * hot[i].second / label_total[k] : 0.0);
+            }
+        }
+    }
+
+    // 多个报告时按模块对比各模式的时间占比
+    if (labels.size() > 1) {
+        map<string, double> all;
+        for (size_t k = 0; k < labels.size(); ++k) {
+            for (const auto& kv : per_label[k]) {
+                all[kv.first] += label_total[k] > 0 ? kv.second.seconds / label_total[k] : 0.0;
+            }
+        }
+        vector<pair<string, double>> ranked(all.begin(), all.end());
+        sort(ranked.begin(), ranked.end(), by_seconds_desc);
+        printf("\n=================================\n");
+        printf("  Share of sampled time by module\n");
+        printf("=================================\n");
+        printf("  %-28s", "module");
+        for (const string& label : labels) {
+            printf(" %10.10s", label.c_str());
+        }
+        printf("\n");
+        for (const auto& r : ranked) {
+            printf("  %-28s", r.first.c_str());
+            for (size_t k = 0; k < labels.size(); ++k) {
+                auto it = per_label[k].find(r.first);
+                double share = it == per_label[k].end() || label_total[k] <= 0 ? 0.0
+                                                                               : it->second.seconds / label_total[k];
+                printf(" %9.1f%%", 100.0 * share);
+            }
+            printf("\n");
+        }
+    }
+    printf("=================================\n");
+    return 0;
+}
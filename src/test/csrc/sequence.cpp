@@ -0,0 +1,191 @@
+#include "include/sequence.h"
+#include "include/simulator.h"
+#include "include/batch_check.h"
+
+#include <cstdio>
+
+using namespace std;
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+coroutine_handle<> Sequence::promise_type::FinalAwaiter::await_suspend(coroutine_handle<promise_type> h) noexcept {
+    promise_type& p = h.promise();
+    if (p.continuation) {
+        return p.continuation; // 子序列: 直接转回父序列
+    }
+    if (p.sched) {
+        p.sched->finished_.push_back(h);
+    }
+    return noop_coroutine();
+}
+
+SeqScheduler::~SeqScheduler() {
+    // run 出错返回时仍挂起的顶层序列，子序列的帧随父序列一起销毁
+    for (void* frame : roots_) {
+        coroutine_handle<>::from_address(frame).destroy();
+    }
+}
+
+void SeqScheduler::spawn(Sequence seq) {
+    Sequence::Handle h = seq.release();
+    h.promise().sched = this;
+    roots_.insert(h.address());
+    ready_.push_back(h);
+    live_++;
+}
+
+bool SeqScheduler::ResultAwaiter::await_ready() {
+    auto it = sched.results_.find(txn);
+    if (it == sched.results_.end()) {
+        return false;
+    }
+    out = it->second;
+    sched.results_.erase(it);
+    return true;
+}
+
+bool SeqScheduler::run(uint64_t timeout) {
+    vector<coroutine_handle<>> resuming;
+    exception_ptr error;
+    uint64_t idle = 0;
+    while (true) {
+        // 1. 恢复本周期就绪的序列，它们会登记下一个要等待的事件
+        while (!ready_.empty()) {
+            resuming.swap(ready_);
+            for (coroutine_handle<> h : resuming) {
+                h.resume();
+            }
+            resuming.clear();
+        }
+        for (Sequence::Handle h : finished_) {
+            if (h.promise().exception && !error) error = h.promise().exception;
+            roots_.erase(h.address());
+            h.destroy();
+            live_--;
+        }
+        finished_.clear();
+        if (error) rethrow_exception(error);
+        if (live_ == 0) break;
+
+        // 2. 没有序列在等待时钟沿或发射口时，只能等待已发射事务的结果
+        if (posedge_waiters_.empty() && issue_queue_.empty()) {
+            if (in_flight_.empty()) {
+                printf("Sequences are waiting for results of transactions that were never issued\n");
+                return false;
+            }
+            if (++idle > timeout) {
+                printf("Timeout waiting for valid_out at cycle %llu\n", (unsigned long long)cycle_);
+                return false;
+            }
+        } else {
+            idle = 0;
+        }
+
+        // 3. 一个时钟周期: 发射口按请求顺序仲裁
+        IssueAwaiter* issuing = nullptr;
+        if (!issue_queue_.empty()) {
+            issuing = issue_queue_.front();
+            issue_queue_.pop_front();
+        }
+        DutOutputs out;
+        bool valid = sim_.step(issuing ? &issuing->test : nullptr, out);
+        cycle_++;
+        if (issuing) {
+            issuing->txn = next_txn_++;
+            in_flight_.push_back(issuing->txn);
+            ready_.push_back(issuing->handle);
+        }
+        if (valid) {
+            if (in_flight_.empty()) {
+                printf("Unexpected valid_out at cycle %llu: more results than issued transactions\n",
+                       (unsigned long long)cycle_);
+                return false;
+            }
+            Txn txn = in_flight_.front();
+            in_flight_.pop_front();
+            auto it = result_waiters_.find(txn);
+            if (it != result_waiters_.end()) {
+                it->second->out = out;
+                ready_.push_back(it->second->handle);
+                result_waiters_.erase(it);
+            } else {
+                results_[txn] = out;
+            }
+            idle = 0;
+        }
+        ready_.insert(ready_.end(), posedge_waiters_.begin(), posedge_waiters_.end());
+        posedge_waiters_.clear();
+    }
+    return true;
+}
+
+// 各检查序列共享的结果记录
+struct SequenceTally {
+    const vector<TestCase>& tests;
+    const vector<size_t>& order;
+    uint64_t max_failures;
+    vector<size_t>& failed;
+    uint64_t& passed;
+    BatchChecker checker;
+
+    bool stopped() const { return max_failures > 0 && failed.size() >= max_failures; }
+};
+
+// 一个检查序列: 流水线方式发射 tests[order[k]] (k = first, first + stride, ...)，
+// 最多保持 window 个未完成事务，结果返回时检查
+static Sequence check_sequence(SeqScheduler& s, SequenceTally& tally, size_t first, size_t stride,
+                               unsigned window) {
+    deque<pair<Txn, size_t>> pending;
+    size_t next = first;
+    while ((next < tally.order.size() && !tally.stopped()) || !pending.empty()) {
+        if (next < tally.order.size() && !tally.stopped() && pending.size() < window) {
+            Txn txn = co_await s.issue(tally.tests[tally.order[next]]);
+            pending.push_back(make_pair(txn, tally.order[next]));
+            next += stride;
+            continue;
+        }
+        DutOutputs out = co_await s.result(pending.front().first);
+        size_t i = pending.front().second;
+        pending.pop_front();
+        if (tally.stopped()) continue; // 失败预算已用完，只等待已发射的事务排空
+        const TestCase& t = tally.tests[i];
+        bool pass = true;
+        if (!tally.checker.fast_check(&t, &out, 1).empty()) {
+            printf("--- Checking test case %zu of %zu ---\n", i + 1, tally.tests.size());
+            t.print_details();
+            pass = t.check_result(out);
+        }
+        if (pass) {
+            tally.passed++;
+        } else {
+            tally.failed.push_back(i);
+        }
+    }
+}
+
+bool run_sequences(Simulator& sim, const vector<TestCase>& tests, const vector<size_t>& order, unsigned n,
+                   unsigned window, uint64_t max_failures, vector<size_t>& failed, uint64_t& passed) {
+    sim.reset(2);
+    SeqScheduler sched(sim);
+    SequenceTally tally{tests, order, max_failures, failed, passed, BatchChecker()};
+    for (unsigned k = 0; k < n; ++k) {
+        sched.spawn(check_sequence(sched, tally, k, n, window));
+    }
+    if (!sched.run()) {
+        return false;
+    }
+    printf("Ran %llu transactions from %u concurrent sequences in %llu cycles (%.3f ops/cycle)\n",
+           (unsigned long long)sched.issued(), n, (unsigned long long)sched.cycle(),
+           sched.cycle() ? (double)sched.issued() / sched.cycle() : 0.0);
+    return true;
+}
+
+#else
+
+bool run_sequences(Simulator&, const vector<TestCase>&, const vector<size_t>&, unsigned, unsigned, uint64_t,
+                   vector<size_t>&, uint64_t&) {
+    printf("--sequences needs C++20 coroutines, rebuild with -std=c++20\n");
+    return false;
+}
+
+#endif // __cpp_impl_coroutine
@@ -0,0 +1,280 @@
+#include "include/signature.h"
+#include "include/simulator.h"
+#include "include/options.h"
+#include "include/batch_check.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+const int kSignatureFileVersion = 2; // 2: 记录 batch 与 issue
+const uint64_t kSignatureInit = 0xCBF29CE484222325ull;
+
+SignatureHasher::SignatureHasher(OutputSignature& sig) : sig_(sig) {
+    sig_.tests = 0;
+    sig_.hash = kSignatureInit;
+    for (int m = 0; m < kNumTestModes; ++m) {
+        sig_.mode_count[m] = 0;
+        sig_.mode_hash[m] = kSignatureInit;
+    }
+    sig_.prefix.clear();
+}
+
+void SignatureHasher::add(TestMode mode, uint32_t beat) {
+    sig_.mode_count[(int)mode]++;
+    sig_.mode_hash[(int)mode] = fold(sig_.mode_hash[(int)mode], beat);
+    sig_.hash = fold(sig_.hash, beat);
+    if (++sig_.tests % sig_.block == 0) {
+        sig_.prefix.push_back(sig_.hash);
+    }
+}
+
+bool write_signature_file(const string& path, const OutputSignature& sig) {
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp) {
+        printf("Cannot open signature file %s\n", path.c_str());
+        return false;
+    }
+    fprintf(fp, "# vfpu output signature\n");
+    fprintf(fp, "version %d\n", kSignatureFileVersion);
+    fprintf(fp, "seed %u\n", sig.seed);
+    fprintf(fp, "shard %u %u\n", sig.shard_index, sig.shard_count);
+    fprintf(fp, "modes %s\n", sig.modes.c_str());
+    fprintf(fp, "count %d\n", sig.num_random_tests);
+    fprintf(fp, "batch %" PRIu64 "\n", sig.batch_size);
+    fprintf(fp, "issue %s\n", sig.issue.c_str());
+    fprintf(fp, "tests %" PRIu64 "\n", sig.tests);
+    fprintf(fp, "block %" PRIu64 "\n", sig.block);
+    fprintf(fp, "hash %016" PRIx64 "\n", sig.hash);
+    for (int m = 0; m < kNumTestModes; ++m) {
+        if (sig.mode_count[m]) {
+            fprintf(fp, "mode %s %" PRIu64 " %016" PRIx64 "\n", test_mode_name((TestMode)m),
+                    sig.mode_count[m], sig.mode_hash[m]);
+        }
+    }
+    for (uint64_t h : sig.prefix) {
+        fprintf(fp, "prefix %016" PRIx64 "\n", h);
+    }
+    return fclose(fp) == 0;
+}
+
+bool read_signature_file(const string& path, OutputSignature& sig) {
+    ifstream in(path);
+    if (!in) {
+        printf("Cannot open signature file %s\n", path.c_str());
+        return false;
+    }
+    sig = OutputSignature();
+    string line;
+    int version = 0;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream ss(line);
+        string key;
+        ss >> key;
+        bool ok = true;
+        if (key == "version") {
+            ok = (bool)(ss >> version);
+        } else if (key == "seed") {
+            ok = (bool)(ss >> sig.seed);
+        } else if (key == "shard") {
+            ok = (bool)(ss >> sig.shard_index >> sig.shard_count);
+        } else if (key == "modes") {
+            ok = (bool)(ss >> sig.modes);
+        } else if (key == "count") {
+            ok = (bool)(ss >> sig.num_random_tests);
+        } else if (key == "batch") {
+            ok = (bool)(ss >> sig.batch_size);
+        } else if (key == "issue") {
+            ok = (bool)(ss >> sig.issue);
+        } else if (key == "tests") {
+            ok = (bool)(ss >> sig.tests);
+        } else if (key == "block") {
+            ok = (bool)(ss >> sig.block) && sig.block > 0;
+        } else if (key == "hash") {
+            ok = (bool)(ss >> hex >> sig.hash);
+        } else if (key == "mode") {
+            string name;
+            TestMode mode;
+            uint64_t count, h;
+            ok = (bool)(ss >> name >> count >> hex >> h) && parse_test_mode(name.c_str(), mode);
+            if (ok) {
+                sig.mode_count[(int)mode] = count;
+                sig.mode_hash[(int)mode] = h;
+            }
+        } else if (key == "prefix") {
+            uint64_t h;
+            ok = (bool)(ss >> hex >> h);
+            if (ok) sig.prefix.push_back(h);
+        }
+        if (!ok) {
+            printf("Malformed line in %s: %s\n", path.c_str(), line.c_str());
+            return false;
+        }
+    }
+    if (version != kSignatureFileVersion) {
+        printf("Unsupported signature file version in %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 以流水线方式运行 pending[begin, end) 中的测试，结果写入 outputs
+static bool stream_range(Simulator& sim, const vector<TestCase>& tests, const vector<size_t>& pending,
+                         size_t begin, size_t end, size_t batch_size, vector<TestCase>& batch,
+                         vector<DutOutputs>& outputs) {
+    batch.clear();
+    for (size_t k = begin; k < end; ++k) {
+        batch.push_back(tests[pending[k]]);
+    }
+    outputs.resize(batch.size());
+    for (size_t pos = 0; pos < batch.size(); pos += batch_size) {
+        size_t count = min(batch_size, batch.size() - pos);
+        if (!sim.run_batch(batch.data() + pos, count, outputs.data() + pos)) {
+            printf("Timeout while streaming test cases %zu..%zu\n", pending[begin + pos] + 1,
+                   pending[begin + pos + count - 1] + 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 两次运行的向量必须相同，签名才有可比性
+static bool same_campaign(const OutputSignature& a, const OutputSignature& b) {
+    return a.seed == b.seed && a.shard_index == b.shard_index && a.shard_count == b.shard_count
+        && a.modes == b.modes && a.num_random_tests == b.num_random_tests && a.block == b.block
+        && a.batch_size == b.batch_size && a.issue == b.issue;
+}
+
+// 从第一个待测向量开始以流水线方式运行 pending[0, end)，每运行一段调用 visit(段起点, batch, outputs)。
+// 每次都从相同的发射状态开始 (发射模式计数器、Bernoulli 使用的 rand())，
+// 批次划分也与 end 无关，因此重放到某个位置时各向量的执行与第一次运行相同
+template <class Visit>
+static bool stream_from_start(Simulator& sim, const SimOptions& opts, uint32_t seed, const vector<TestCase>& tests,
+                              const vector<size_t>& pending, size_t end, vector<TestCase>& batch,
+                              vector<DutOutputs>& outputs, Visit visit) {
+    sim.set_issue_pattern(opts.issue, opts.latency);
+    srand(seed);
+    const size_t chunk = 16 * opts.batch_size;
+    for (size_t pos = 0; pos < end; pos += chunk) {
+        size_t stop = min(pos + chunk, end);
+        if (!stream_range(sim, tests, pending, pos, stop, opts.batch_size, batch, outputs)) {
+            return false;
+        }
+        visit(pos, batch, outputs);
+    }
+    return true;
+}
+
+int run_signature(Simulator& sim, const SimOptions& opts, vector<TestCase>& tests, const vector<size_t>& pending,
+                  OutputSignature& sig, const OutputSignature* expected) {
+    if (expected && !same_campaign(sig, *expected)) {
+        printf("Signature was recorded for a different campaign (seed/shard/modes/count/block/batch/issue)\n");
+        return 1;
+    }
+
+    // 1. 只仿真、不计算参考结果，输出折叠进滚动哈希
+    SignatureHasher hasher(sig);
+    vector<TestCase> batch;
+    vector<DutOutputs> outputs;
+    if (!stream_from_start(sim, opts, sig.seed, tests, pending, pending.size(), batch, outputs,
+                           [&](size_t, const vector<TestCase>& b, const vector<DutOutputs>& out) {
+                               for (size_t k = 0; k < b.size(); ++k) {
+                                   hasher.add(b[k].mode, b[k].packed_output(out[k]));
+                               }
+                           })) {
+        return 1;
+    }
+
+    if (!expected) {
+        if (!write_signature_file(opts.record_signature_path, sig)) {
+            return 1;
+        }
+        printf("Signature of %" PRIu64 " outputs (%016" PRIx64 ") written to %s\n", sig.tests, sig.hash,
+               opts.record_signature_path.c_str());
+        return 0;
+    }
+
+    // 2. 比较
+    printf("\n=================================\n");
+    printf("  Signature check (shard %u/%u)\n", sig.shard_index, sig.shard_count);
+    printf("=================================\n");
+    for (int m = 0; m < kNumTestModes; ++m) {
+        if (!sig.mode_count[m] && !expected->mode_count[m]) continue;
+        bool same = sig.mode_count[m] == expected->mode_count[m] && sig.mode_hash[m] == expected->mode_hash[m];
+        printf("  %-12s %10" PRIu64 " outputs  %016" PRIx64 "  %s\n", test_mode_name((TestMode)m),
+               sig.mode_count[m], sig.mode_hash[m], same ? "match" : "DIFFER");
+    }
+    if (sig.tests == expected->tests && sig.hash == expected->hash) {
+        printf("All %" PRIu64 " outputs match the signature\n", sig.tests);
+        printf("=================================\n");
+        return 0;
+    }
+    if (sig.tests != expected->tests) {
+        printf("Output count differs: %" PRIu64 " vs %" PRIu64 " in the signature\n", sig.tests, expected->tests);
+        printf("=================================\n");
+        return 1;
+    }
+
+    // 3. 二分查找第一个前缀哈希不一致的块 (前缀一旦不同，之后的前缀都不同)
+    size_t lo = 0, hi = min(sig.prefix.size(), expected->prefix.size());
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (sig.prefix[mid] != expected->prefix[mid]) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    size_t begin = lo * sig.block;
+    size_t end = min(begin + (size_t)sig.block, pending.size());
+    printf("First diverging block %zu: test cases %zu..%zu\n", lo, pending[begin] + 1, pending[end - 1] + 1);
+
+    // 4. 只对该块计算参考结果，从头重放到该块所在批次的末尾，使该块以相同的流水线状态执行，
+    //    重放的前缀哈希与本次运行一致时，检查的就是本次运行的输出
+    for (size_t k = begin; k < end; ++k) {
+        tests[pending[k]].compute_expected();
+    }
+    const size_t replay_end = min((end + opts.batch_size - 1) / opts.batch_size * opts.batch_size, pending.size());
+    OutputSignature replay_sig;
+    replay_sig.block = sig.block;
+    SignatureHasher replay_hasher(replay_sig);
+    vector<TestCase> block_tests;
+    vector<DutOutputs> block_outputs;
+    if (!stream_from_start(sim, opts, sig.seed, tests, pending, replay_end, batch, outputs,
+                           [&](size_t pos, const vector<TestCase>& b, const vector<DutOutputs>& out) {
+                               for (size_t k = 0; k < b.size() && pos + k < end; ++k) {
+                                   replay_hasher.add(b[k].mode, b[k].packed_output(out[k]));
+                                   if (pos + k >= begin) {
+                                       block_tests.push_back(b[k]);
+                                       block_outputs.push_back(out[k]);
+                                   }
+                               }
+                           })) {
+        return 1;
+    }
+    uint64_t run_hash = lo < sig.prefix.size() ? sig.prefix[lo] : sig.hash;
+    if (replay_sig.hash != run_hash) {
+        printf("NOTE: the replay did not reproduce this run's outputs, the check below is approximate\n");
+    }
+    BatchChecker checker;
+    const vector<size_t>& mismatches = checker.fast_check(block_tests.data(), block_outputs.data(),
+                                                          block_tests.size());
+    for (size_t k : mismatches) {
+        printf("--- Checking test case %zu of %zu ---\n", pending[begin + k] + 1, tests.size());
+        block_tests[k].print_details();
+        if (!block_tests[k].check_result(block_outputs[k])) {
+            printf("First failing test case in the block: %zu\n", pending[begin + k] + 1);
+            printf("=================================\n");
+            return 1;
+        }
+    }
+    printf("Outputs in the block differ from the signature but pass the reference check\n");
+    printf("=================================\n");
+    return 1;
+}
@@ -0,0 +1,324 @@
+#include "include/sim_server.h"
+#include "include/simulator.h"
+#include "include/batch_check.h"
+#include "include/softfloat_ref.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// 已复位的 Simulator 实例池，每个请求独占一个实例
+class SimulatorPool {
+public:
+    SimulatorPool(const SimOptions& opts, unsigned n) {
+        vector<char*> args = opts.verilator_args;
+        for (unsigned k = 0; k < n; ++k) {
+            sims_.emplace_back(new Simulator((int)args.size(), args.data(), opts.threads));
+            sims_.back()->set_issue_pattern(opts.issue, opts.latency);
+            free_.push_back(sims_.back().get());
+        }
+    }
+
+    Simulator* acquire() {
+        unique_lock<mutex> lock(lock_);
+        ready_.wait(lock, [this] { return !free_.empty(); });
+        Simulator* sim = free_.back();
+        free_.pop_back();
+        return sim;
+    }
+
+    void release(Simulator* sim) {
+        {
+            lock_guard<mutex> guard(lock_);
+            free_.push_back(sim);
+        }
+        ready_.notify_one();
+    }
+
+    // 作用域结束时归还实例 (包括异常退出)
+    struct Lease {
+        SimulatorPool& pool;
+        Simulator* sim;
+        explicit Lease(SimulatorPool& p) : pool(p), sim(p.acquire()) {}
+        ~Lease() { pool.release(sim); }
+    };
+
+private:
+    vector<unique_ptr<Simulator>> sims_;
+    vector<Simulator*> free_;
+    mutex lock_;
+    condition_variable ready_;
+};
+
+// 客户端共享内存的映射。每个请求都重新 shm_open，对象仍是同一个 (st_dev/st_ino 相同)
+// 且足够大时才复用映射: 客户端可能在两批之间 unlink 并重新创建同名对象
+struct ShmMapping {
+    void* base = MAP_FAILED;
+    size_t size = 0;
+    dev_t dev = 0;
+    ino_t ino = 0;
+
+    ~ShmMapping() { unmap(); }
+
+    void unmap() {
+        if (base != MAP_FAILED) munmap(base, size);
+        base = MAP_FAILED;
+    }
+
+    bool map(const string& shm_name, size_t need) {
+        int fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            unmap();
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < need) {
+            close(fd);
+            unmap();
+            return false;
+        }
+        if (base != MAP_FAILED && dev == st.st_dev && ino == st.st_ino && size >= need) {
+            close(fd);
+            return true;
+        }
+        unmap();
+        size = (size_t)st.st_size;
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) return false;
+        dev = st.st_dev;
+        ino = st.st_ino;
+        return true;
+    }
+};
+
+// 慢路径检查会打印详细信息，在锁内进行以免各连接的输出交错
+static mutex check_lock;
+
+static bool read_full(int fd, void* buf, size_t n) {
+    char* p = (char*)buf;
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r <= 0) return false;
+        p += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+static bool write_full(int fd, const void* buf, size_t n) {
+    const char* p = (const char*)buf;
+    while (n > 0) {
+        ssize_t r = send(fd, p, n, MSG_NOSIGNAL);
+        if (r <= 0) return false;
+        p += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+static int32_t run_request(SimulatorPool& pool, const SimOptions& opts, const ServerRequest& req, ShmMapping& shm,
+                           vector<TestCase>& tests, vector<DutOutputs>& outputs, BatchChecker& checker,
+                           ServerResponse& resp) {
+    // mismatch 下标为 uint32_t，16 * count 也不能溢出 size_t
+    if (req.mode >= (uint32_t)kNumTestModes || req.count == 0 || req.count > UINT32_MAX
+        || req.count > SIZE_MAX / 16) {
+        return kServerBadRequest;
+    }
+    string name(req.shm_name, strnlen(req.shm_name, sizeof(req.shm_name)));
+    if (!shm.map(name, 16 * req.count)) {
+        return kServerBadShm;
+    }
+    const size_t n = req.count;
+    const uint32_t* a = (const uint32_t*)shm.base;
+    const uint32_t* b = a + n;
+    uint32_t* out = (uint32_t*)shm.base + 2 * n;
+    uint32_t* mismatch = (uint32_t*)shm.base + 3 * n;
+
+    // 服务进程关闭了构造时的参考计算，操作数直接按端口打包写入;
+    // Widen 模式只使用高16位，低16位按 TestCase 的约定清零
+    const TestMode mode = (TestMode)req.mode;
+    const uint32_t operand_mask = (mode == TestMode::FP16_Widen || mode == TestMode::BF16_Widen) ? 0xFFFF0000u
+                                                                                                : 0xFFFFFFFFu;
+    tests.assign(n, TestCase(FADD_Operands_Hex{0, 0}, ErrorType::Precise));
+    for (size_t i = 0; i < n; ++i) {
+        tests[i].mode = mode;
+        tests[i].a_bits = a[i] & operand_mask;
+        tests[i].b_bits = b[i] & operand_mask;
+    }
+    outputs.resize(n);
+
+    bool ok = true;
+    {
+        SimulatorPool::Lease lease(pool);
+        auto begin = chrono::steady_clock::now();
+        for (size_t pos = 0; pos < n && ok; pos += opts.batch_size) {
+            size_t count = min((size_t)opts.batch_size, n - pos);
+            ok = lease.sim->run_batch(tests.data() + pos, count, outputs.data() + pos);
+        }
+        resp.sim_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+    }
+    if (!ok) {
+        return kServerTimeout;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = tests[i].packed_output(outputs[i]);
+    }
+    resp.count = n;
+
+    if (req.flags & kServerCheck) {
+        // 参考模型是线程安全的，只有打印需要串行
+        compute_expected_batch(tests.data(), n);
+        const vector<size_t>& slow = checker.fast_check(tests.data(), outputs.data(), n);
+        lock_guard<mutex> guard(check_lock);
+        for (size_t k : slow) {
+            printf("--- Checking vector %zu of %s request ---\n", k, test_mode_name(mode));
+            tests[k].print_details();
+            if (!tests[k].check_result(outputs[k])) {
+                mismatch[resp.mismatches++] = (uint32_t)k;
+            }
+        }
+        fflush(stdout);
+    }
+    return kServerOk;
+}
+
+// 打开的客户端连接，停止时关闭其读端，使空闲连接的线程退出;
+// 连接线程结束前把自己的 id 放入 finished，由接受连接的线程 join
+struct ConnectionSet {
+    mutex lock;
+    set<int> fds;
+    vector<thread::id> finished;
+};
+
+static void serve_connection(int fd, SimulatorPool& pool, const SimOptions& opts, atomic<bool>& stop,
+                             int listen_fd, ConnectionSet& conns) {
+    ShmMapping shm;
+    vector<TestCase> tests;
+    vector<DutOutputs> outputs;
+    BatchChecker checker;
+    ServerRequest req;
+    while (read_full(fd, &req, sizeof(req))) {
+        ServerResponse resp = {};
+        resp.magic = kServerResponseMagic;
+        if (req.magic != kServerRequestMagic) {
+            resp.status = kServerBadRequest;
+            write_full(fd, &resp, sizeof(resp));
+            break; // 无法再与客户端同步
+        }
+        switch ((ServerOp)req.op) {
+        case ServerOp::Run:
+            // 异常 (例如 count 很大时内存不足) 只让本次请求失败，不终止整个服务进程
+            try {
+                resp.status = run_request(pool, opts, req, shm, tests, outputs, checker, resp);
+            } catch (const exception& e) {
+                printf("Request of %llu vectors failed: %s\n", (unsigned long long)req.count, e.what());
+                fflush(stdout);
+                tests = vector<TestCase>();
+                outputs = vector<DutOutputs>();
+                resp = ServerResponse{kServerResponseMagic, kServerInternalError, 0, 0, 0};
+            }
+            break;
+        case ServerOp::Ping:
+            break;
+        case ServerOp::Shutdown:
+            stop = true;
+            shutdown(listen_fd, SHUT_RDWR); // 唤醒 accept
+            break;
+        default:
+            resp.status = kServerBadRequest;
+            break;
+        }
+        if (!write_full(fd, &resp, sizeof(resp))) break;
+    }
+    lock_guard<mutex> guard(conns.lock);
+    close(fd);
+    conns.fds.erase(fd);
+    conns.finished.push_back(this_thread::get_id());
+}
+
+int run_server(const SimOptions& opts) {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (opts.serve_path.size() >= sizeof(addr.sun_path)) {
+        printf("Socket path too long: %s\n", opts.serve_path.c_str());
+        return 1;
+    }
+    strcpy(addr.sun_path, opts.serve_path.c_str());
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(opts.serve_path.c_str());
+    if (listen_fd < 0 || bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 16) != 0) {
+        printf("Cannot listen on %s: %s\n", opts.serve_path.c_str(), strerror(errno));
+        return 1;
+    }
+
+    set_reference_enabled(false);
+    SimulatorPool pool(opts, opts.serve_instances);
+    printf("--- Serving on %s with %u warm instance(s) ---\n", opts.serve_path.c_str(), opts.serve_instances);
+    fflush(stdout);
+
+    atomic<bool> stop(false);
+    ConnectionSet conns;
+    map<thread::id, thread> workers; // 只由本线程访问
+    auto reap = [&] {
+        vector<thread::id> finished;
+        {
+            lock_guard<mutex> guard(conns.lock);
+            finished.swap(conns.finished);
+        }
+        for (thread::id id : finished) {
+            auto it = workers.find(id);
+            it->second.join();
+            workers.erase(it);
+        }
+    };
+    while (!stop) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        reap();
+        lock_guard<mutex> guard(conns.lock);
+        conns.fds.insert(fd);
+        thread worker(serve_connection, fd, ref(pool), cref(opts), ref(stop), listen_fd, ref(conns));
+        thread::id id = worker.get_id();
+        workers.emplace(id, move(worker));
+    }
+    {
+        lock_guard<mutex> guard(conns.lock);
+        for (int fd : conns.fds) {
+            shutdown(fd, SHUT_RD);
+        }
+    }
+    // 连接线程都结束后 pool、conns 才会析构
+    for (auto& w : workers) {
+        w.second.join();
+    }
+    close(listen_fd);
+    unlink(opts.serve_path.c_str());
+    printf("--- Server stopped ---\n");
+    return 0;
+}
@@ -1,65 +1,350 @@
 // sim_c/sim.cc
 #include "include/simulator.h"
+#include "include/format_traits.h"
+#include "include/perf_trace.h"
+#include <cstdlib>
 #include <verilated.h>
 #include "Vtop.h"
-#ifdef VCD
+#if defined(FST)
+    #include "verilated_fst_c.h"
+#elif defined(VCD)
     #include "verilated_vcd_c.h"
 #endif
+#ifdef SAVABLE
+    #include "verilated_save.h"
+#endif
+#ifdef ACTIVITY_SCOPES
+    #include "verilated_syms.h"
+#endif
+#ifdef COVERAGE
+    #include "verilated_cov.h"
+    #include "Vtop__Syms.h"
+#endif
 
 #include <iostream>
 #include <bitset>
+#include <cstdio>
+#include <chrono>
 
 using namespace std; 
 
+// ===================================================================
+// 按 TestMode 编译期特化的端口驱动
+// ===================================================================
+// TestCase 中的操作数已按DUT端口打包，top 中 a = Cat(a_in_16(1), a_in_16(0))，
+// 因此32位端口与两个16位端口可以直接由同一个打包值驱动:
+//   FP16/BF16: 低16位为第1路，高16位为第2路
+//   Widen:     16位操作数位于高16位 (io_*_in_16_1)，低16位为0
+// 注意：Verilator会把 a_in_16: Vec(2, UInt(16.W)) 转换成 io_a_in_16_0, io_a_in_16_1
+
+// 控制信号: 同构的一批测试只需写一次
+template <TestMode M>
+static void drive_mode(Vtop* top) {
+    typedef ModeTraits<M> T;
+    top->io_is_fp32  = T::is_fp32;
+    top->io_is_fp16  = T::is_fp16;
+    top->io_is_bf16  = T::is_bf16;
+    top->io_is_widen = T::is_widen;
+    top->io_a_already_widen = 0; // 新增信号连接，设为0
+}
+
+// 数据输入: 每个测试写一次
+template <TestMode M>
+static inline void drive_operands(Vtop* top, const TestCase& test) {
+    if (ModeTraits<M>::is_fp32) {
+        top->io_a_in_32 = test.a_bits;
+        top->io_b_in_32 = test.b_bits;
+    } else {
+        top->io_a_in_16_0 = test.a16(0);
+        top->io_a_in_16_1 = test.a16(1);
+        top->io_b_in_16_0 = test.b16(0);
+        top->io_b_in_16_1 = test.b16(1);
+    }
+}
+
+struct PortDriver {
+    void (*drive_mode)(Vtop* top);
+    void (*drive_operands)(Vtop* top, const TestCase& test);
+};
+
+static const PortDriver& port_driver(TestMode mode) {
+    static const PortDriver table[kNumTestModes] = {
+        { drive_mode<TestMode::FP32>,       drive_operands<TestMode::FP32> },
+        { drive_mode<TestMode::FP16>,       drive_operands<TestMode::FP16> },
+        { drive_mode<TestMode::BF16>,       drive_operands<TestMode::BF16> },
+        { drive_mode<TestMode::FP16_Widen>, drive_operands<TestMode::FP16_Widen> },
+        { drive_mode<TestMode::BF16_Widen>, drive_operands<TestMode::BF16_Widen> },
+    };
+    return table[(int)mode];
+}
+
+// 周期级激励记录/回放: top 输入与 PortInputs 之间的转换
+static PortInputs sample_inputs(const Vtop* top) {
+    PortInputs in;
+    in.ctrl = (top->reset ? kStimReset : 0) | (top->io_valid_in ? kStimValidIn : 0)
+            | (top->io_is_fp32 ? kStimIsFp32 : 0) | (top->io_is_fp16 ? kStimIsFp16 : 0)
+            | (top->io_is_bf16 ? kStimIsBf16 : 0) | (top->io_is_widen ? kStimIsWiden : 0)
+            | (top->io_a_already_widen ? kStimAlreadyWiden : 0);
+    in.a_in_32 = top->io_a_in_32;
+    in.b_in_32 = top->io_b_in_32;
+    in.a_in_16[0] = top->io_a_in_16_0;
+    in.a_in_16[1] = top->io_a_in_16_1;
+    in.b_in_16[0] = top->io_b_in_16_0;
+    in.b_in_16[1] = top->io_b_in_16_1;
+    return in;
+}
+
+static void apply_inputs(Vtop* top, const PortInputs& in) {
+    top->reset = (in.ctrl & kStimReset) != 0;
+    top->io_valid_in = (in.ctrl & kStimValidIn) != 0;
+    top->io_is_fp32 = (in.ctrl & kStimIsFp32) != 0;
+    top->io_is_fp16 = (in.ctrl & kStimIsFp16) != 0;
+    top->io_is_bf16 = (in.ctrl & kStimIsBf16) != 0;
+    top->io_is_widen = (in.ctrl & kStimIsWiden) != 0;
+    top->io_a_already_widen = (in.ctrl & kStimAlreadyWiden) != 0;
+    top->io_a_in_32 = in.a_in_32;
+    top->io_b_in_32 = in.b_in_32;
+    top->io_a_in_16_0 = in.a_in_16[0];
+    top->io_a_in_16_1 = in.a_in_16[1];
+    top->io_b_in_16_0 = in.b_in_16[0];
+    top->io_b_in_16_1 = in.b_in_16[1];
+}
+
 // ===================================================================
 // Simulator 类实现
 // ===================================================================
 
-Simulator::Simulator(int argc, char* argv[]) {
+Simulator::Simulator(int argc, char* argv[], unsigned threads) {
     contextp_ = make_unique<VerilatedContext>();
     contextp_->commandArgs(argc, argv);
-    top_ = make_unique<Vtop>(contextp_.get());
-
-#ifdef VCD
-    init_vcd();
+    // 必须在创建模型之前设置，线程池随第一个模型创建
+    if (threads) {
+        contextp_->threads(threads);
+    }
+#ifdef WAVE_TRACE
+    // 跟踪必须在创建模型之前开启，之后由 open_wave 决定是否写出波形
+    contextp_->traceEverOn(true);
 #endif
+    top_ = make_unique<Vtop>(contextp_.get());
 }
 
 Simulator::~Simulator() {
-#ifdef VCD
+    if (activity_) {
+        activity_->print_summary();
+        activity_->write(activity_opts_);
+    }
+    if (stimulus_) {
+        stimulus_->close();
+        printf("Stimulus trace of %llu cycles written\n", (unsigned long long)stimulus_->cycles());
+    }
+#ifdef WAVE_TRACE
     if (tfp_) {
         tfp_->close();
+        delete tfp_;
     }
 #endif
 }
 
-void Simulator::init_vcd() {
-#ifdef VCD
-    contextp_->traceEverOn(true);
-    tfp_ = new VerilatedVcdC;
-    top_->trace(tfp_, 99);
-    tfp_->open("build/vfpu/top.vcd");
+unsigned Simulator::model_threads() const {
+    return top_->threads();
+}
+
+unsigned Simulator::context_threads() const {
+    return contextp_->threads();
+}
+
+unsigned Simulator::verilated_threads() {
+    static const unsigned threads = [] {
+        VerilatedContext context;
+        Vtop probe(&context);
+        return (unsigned)probe.threads();
+    }();
+    return threads;
+}
+
+#ifdef WAVE_TRACE
+bool Simulator::open_wave(const WaveOptions& wave) {
+    string path = wave.path.empty() ? WAVE_DEFAULT_PATH : wave.path;
+    tfp_ = new WaveTracer;
+    // dumpvars 必须在 open 之前调用。层数为从该层次起跟踪的层数，必须为正:
+    // Verilator 中层数 0 会清空 dumpvars 列表，即跟踪全部信号
+    for (const string& scope : wave.scopes) {
+        tfp_->dumpvars(wave.depth, scope);
+    }
+    top_->trace(tfp_, wave.depth);
+    tfp_->open(path.c_str());
+    if (!tfp_->isOpen()) {
+        printf("Cannot open waveform file %s\n", path.c_str());
+        delete tfp_;
+        tfp_ = nullptr;
+        return false;
+    }
+    wave_begin_ = wave.begin_cycle;
+    wave_end_ = wave.end_cycle;
+    return true;
+}
 #endif
+
+void Simulator::eval() {
+    TRACE_HOT_SCOPE("Vtop::eval");
+    if (!profile_eval_) {
+        top_->eval();
+        return;
+    }
+    auto begin = chrono::steady_clock::now();
+    top_->eval();
+    eval_profile_.eval_ns[(int)cur_mode_] +=
+        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
 }
 
 void Simulator::single_cycle() {
+#ifdef WAVE_TRACE
+    // 周期窗口之外不调用 dump，进入窗口后第一次 dump 写出全部跟踪信号的当前值
+    bool dump = tfp_ && cycles_ >= wave_begin_ && (!wave_end_ || cycles_ < wave_end_);
+#endif
+    cycles_++;
+    eval_profile_.cycles[(int)cur_mode_]++;
+    // 记录时在上升沿之前采样输入
+    PortInputs sampled;
+    if (stimulus_) {
+        sampled = sample_inputs(top_.get());
+    }
     top_->clock = 0;
-    top_->eval();
-#ifdef VCD
-    if (tfp_) {
+    eval();
+#ifdef WAVE_TRACE
+    if (dump) {
         tfp_->dump(contextp_->time());
     }
 #endif
     contextp_->timeInc(1);
 
     top_->clock = 1;
-    top_->eval();
-#ifdef VCD
-    if (tfp_) {
+    eval();
+#ifdef WAVE_TRACE
+    if (dump) {
         tfp_->dump(contextp_->time());
     }
 #endif
     contextp_->timeInc(1);
+
+    if (activity_) {
+        activity_->sample(cur_mode_, top_->io_valid_in);
+    }
+    if (stimulus_) {
+        DutOutputs out;
+        if (top_->io_valid_out) out = read_outputs();
+        stimulus_->cycle(sampled, top_->io_valid_out ? &out : nullptr);
+    }
+}
+
+bool Simulator::enable_activity(const ActivityOptions& opts) {
+    const struct {
+        const char* name;
+        const void* data;
+        int width;
+    } ports[] = {
+        { "reset",              &top_->reset,              1 },
+        { "io_valid_in",        &top_->io_valid_in,        1 },
+        { "io_is_bf16",         &top_->io_is_bf16,         1 },
+        { "io_is_fp16",         &top_->io_is_fp16,         1 },
+        { "io_is_fp32",         &top_->io_is_fp32,         1 },
+        { "io_is_widen",        &top_->io_is_widen,        1 },
+        { "io_a_already_widen", &top_->io_a_already_widen, 1 },
+        { "io_a_in_32",         &top_->io_a_in_32,         32 },
+        { "io_b_in_32",         &top_->io_b_in_32,         32 },
+        { "io_a_in_16_0",       &top_->io_a_in_16_0,       16 },
+        { "io_a_in_16_1",       &top_->io_a_in_16_1,       16 },
+        { "io_b_in_16_0",       &top_->io_b_in_16_0,       16 },
+        { "io_b_in_16_1",       &top_->io_b_in_16_1,       16 },
+        { "io_res_out_32",      &top_->io_res_out_32,      32 },
+        { "io_res_out_16_0",    &top_->io_res_out_16_0,    16 },
+        { "io_res_out_16_1",    &top_->io_res_out_16_1,    16 },
+        { "io_valid_out",       &top_->io_valid_out,       1 },
+    };
+    unique_ptr<ActivityMonitor> monitor(new ActivityMonitor);
+    if (opts.signals.empty()) {
+        for (const auto& p : ports) {
+            monitor->add_signal("top", p.name, p.data, p.width);
+        }
+    }
+    for (const string& name : opts.signals) {
+        bool found = false;
+        for (const auto& p : ports) {
+            if (name == p.name) {
+                monitor->add_signal("top", p.name, p.data, p.width);
+                found = true;
+            }
+        }
+        if (found) continue;
+        size_t dot = name.rfind('.');
+        if (dot == string::npos) {
+            printf("Unknown port %s\n", name.c_str());
+            return false;
+        }
+#ifdef ACTIVITY_SCOPES
+        // 内部信号: 最后一个 '.' 之前为 Verilator 作用域名 (TOP.top.fadd)，SAIF 中去掉 "TOP."
+        const VerilatedScope* scope = contextp_->scopeFind(name.substr(0, dot).c_str());
+        const VerilatedVar* var = scope ? scope->varFind(name.substr(dot + 1).c_str()) : nullptr;
+        if (!var || var->udims() > 0) {
+            printf("Signal %s not found or not a packed signal (verilate with --public-flat-rw)\n", name.c_str());
+            return false;
+        }
+        string path = name.substr(0, dot);
+        if (path.compare(0, 4, "TOP.") == 0) path = path.substr(4);
+        monitor->add_signal(path, name.substr(dot + 1), var->datap(), var->packed().elements());
+#else
+        printf("Internal signal %s needs -DACTIVITY_SCOPES and verilator --public-flat-rw\n", name.c_str());
+        return false;
+#endif
+    }
+    activity_ = move(monitor);
+    activity_opts_ = opts;
+    return true;
+}
+
+bool Simulator::record_stimulus(const string& path) {
+    stimulus_.reset(new StimulusWriter);
+    if (!stimulus_->open(path)) {
+        stimulus_.reset();
+        return false;
+    }
+    return true;
+}
+
+bool Simulator::replay_stimulus(const string& path, StimulusReplayStats& stats) {
+    TRACE_SCOPE("Simulator::replay_stimulus");
+    StimulusReader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    stats = StimulusReplayStats();
+    PortInputs in;
+    bool expect_valid;
+    DutOutputs expected;
+    while (reader.next(in, expect_valid, expected)) {
+        apply_inputs(top_.get(), in);
+        single_cycle();
+        stats.cycles++;
+        bool valid = top_->io_valid_out;
+        bool same = valid == expect_valid;
+        if (valid) {
+            stats.valid_outs++;
+            DutOutputs out = read_outputs();
+            same = same && out.res_out_32 == expected.res_out_32 && out.res_out_16_0 == expected.res_out_16_0
+                && out.res_out_16_1 == expected.res_out_16_1;
+        }
+        if (!same) {
+            if (!stats.mismatches) stats.first_mismatch = stats.cycles;
+            stats.mismatches++;
+        }
+    }
+    top_->io_valid_in = 0;
+    if (reader.corrupt() || stats.cycles != reader.header().cycles) {
+        printf("Stimulus trace %s is truncated or corrupt after %llu cycles\n", path.c_str(),
+               (unsigned long long)stats.cycles);
+        return false;
+    }
+    return true;
 }
 
 void Simulator::reset(int n) {
@@ -71,58 +356,21 @@ void Simulator::reset(int n) {
     top_->eval();
 }
 
-bool Simulator::run_test(const TestCase& test) {
+bool Simulator::run_test(const TestCase& test, bool* timed_out) {
+    TRACE_HOT_SCOPE("Simulator::run_test");
     test.print_details();
+    cur_mode_ = test.mode;
+    eval_profile_.ops[(int)test.mode]++;
 
     // -- 执行仿真 --
     // 复位DUT
     reset(2);
 
     // 1. 设置控制信号和数据输入
+    const PortDriver& driver = port_driver(test.mode);
+    driver.drive_mode(top_.get());
+    driver.drive_operands(top_.get(), test);
     top_->io_valid_in = 1;
-    top_->io_is_fp32  = test.is_fp32;
-    top_->io_is_fp16  = test.is_fp16;
-    top_->io_is_bf16  = test.is_bf16;
-    top_->io_is_widen = test.is_widen;
-    top_->io_a_already_widen = 0; // 新增信号连接，设为0
-
-    // 2. 根据模式设置数据输入端口
-    switch(test.mode) {
-        case TestMode::FP32:
-            top_->io_a_in_32 = test.a_fp32_bits;
-            top_->io_b_in_32 = test.b_fp32_bits;
-            break;
-        case TestMode::FP16:
-            // 注意：Verilator会把 a_in_16: Vec(2, UInt(16.W)) 转换成 io_a_in_16_0, io_a_in_16_1
-            top_->io_a_in_16_0 = test.a1_fp16_bits;
-            top_->io_b_in_16_0 = test.b1_fp16_bits;
-            top_->io_a_in_16_1 = test.a2_fp16_bits;
-            top_->io_b_in_16_1 = test.b2_fp16_bits;
-            break;
-        case TestMode::BF16:
-            // BF16也使用16位端口
-            top_->io_a_in_16_0 = test.a1_bf16_bits;
-            top_->io_b_in_16_0 = test.b1_bf16_bits;
-            top_->io_a_in_16_1 = test.a2_bf16_bits;
-            top_->io_b_in_16_1 = test.b2_bf16_bits;
-            break;
-        case TestMode::FP16_Widen:
-            // FP16 Widen: a,b是FP16, result是FP32
-            // 在test_case中，a,b的fp16值被存在了a_fp32_bits和b_fp32_bits的高16位中
-            top_->io_a_in_16_0 = 0;
-            top_->io_a_in_16_1 = (test.a_fp32_bits >> 16) & 0xFFFF;
-            top_->io_b_in_16_0 = 0;
-            top_->io_b_in_16_1 = (test.b_fp32_bits >> 16) & 0xFFFF;
-            break;
-        case TestMode::BF16_Widen:
-            // BF16 Widen: a,b是BF16, result是FP32
-            // 在test_case中，a,b的bf16值被存在了a_fp32_bits和b_fp32_bits的高16位中
-            top_->io_a_in_16_0 = 0;
-            top_->io_a_in_16_1 = (test.a_fp32_bits >> 16) & 0xFFFF;
-            top_->io_b_in_16_0 = 0;
-            top_->io_b_in_16_1 = (test.b_fp32_bits >> 16) & 0xFFFF;
-            break;
-    }
 
     // 输入有效，等待一个周期，让DUT接收数据
     single_cycle();
@@ -137,11 +385,9 @@ bool Simulator::run_test(const TestCase& test) {
     }
 
     // -- 获取DUT输出并检查结果 --
+    if (timed_out) *timed_out = !top_->io_valid_out;
     if (top_->io_valid_out) {
-        DutOutputs dut_res;
-        dut_res.res_out_32 = top_->io_res_out_32;
-        dut_res.res_out_16_0 = top_->io_res_out_16_0;
-        dut_res.res_out_16_1 = top_->io_res_out_16_1;
+        DutOutputs dut_res = read_outputs();
         bool result = test.check_result(dut_res);
         
         // 如果测试失败，多跑一个周期来记录更多波形信息
@@ -155,4 +401,276 @@ bool Simulator::run_test(const TestCase& test) {
         printf("Timeout waiting for valid_out\n");
         return false;
     }
-}
\ No newline at end of file
+}
+
+bool Simulator::step(const TestCase* issue, DutOutputs& out) {
+    if (issue) {
+        const PortDriver& driver = port_driver(issue->mode);
+        driver.drive_mode(top_.get());
+        driver.drive_operands(top_.get(), *issue);
+        top_->io_valid_in = 1;
+        cur_mode_ = issue->mode;
+        eval_profile_.ops[(int)issue->mode]++;
+    } else {
+        top_->io_valid_in = 0;
+    }
+    single_cycle();
+    if (!top_->io_valid_out) {
+        return false;
+    }
+    out = read_outputs();
+    return true;
+}
+
+void Simulator::set_issue_pattern(const IssuePattern& pattern, uint64_t latency) {
+    issue_gen_ = IssueGenerator(pattern);
+    expected_latency_ = latency;
+}
+
+DutOutputs Simulator::read_outputs() const {
+    DutOutputs dut_res;
+    dut_res.res_out_32 = top_->io_res_out_32;
+    dut_res.res_out_16_0 = top_->io_res_out_16_0;
+    dut_res.res_out_16_1 = top_->io_res_out_16_1;
+    return dut_res;
+}
+
+// ===================================================================
+// 流水线批量执行
+// ===================================================================
+// 按发射模式 (默认每周期一个) 发射测试，DUT输出按发射顺序收集。批次被切分为同一 TestMode
+// 的连续段，每段调用按模式特化的 issue_homogeneous<M>，控制信号只在段首写一次，
+// 热循环中只剩数据端口的写入与结果读取。段与段之间不排空流水线，
+// 因此模式切换会在流水线中仍有其它格式数据时到达DUT (与向量单元背靠背
+// 切换SEW的场景一致)，只在整批发射完后才排空。
+
+// 收集一个周期的DUT输出，并检查 valid_out 是否恰好在发射后固定延迟出现。
+// 输出多于发射数或延迟不符时返回 false
+bool Simulator::collect_output(StreamState& st) {
+    if (!top_->io_valid_out) {
+        return true;
+    }
+    if (st.received >= st.issued) {
+        printf("Unexpected valid_out at cycle %llu: more results than issued operations\n",
+               (unsigned long long)cycles_);
+        stream_stats_.latency_errors++;
+        return false;
+    }
+    // 延迟: 从采样 valid_in 的时钟沿到 valid_out 有效的时钟沿 (含两端)
+    uint64_t latency = cycles_ - st.issue_cycles[st.received] + 1;
+    if (expected_latency_ == 0) {
+        expected_latency_ = latency; // 未指定时以第一个结果的延迟为准
+    } else if (latency != expected_latency_) {
+        printf("valid_out timing error: result %zu arrived %llu cycles after issue, expected %llu\n",
+               st.received, (unsigned long long)latency, (unsigned long long)expected_latency_);
+        stream_stats_.latency_errors++;
+        return false;
+    }
+    st.results[st.received++] = read_outputs();
+    return true;
+}
+
+// 空泡周期驱动无关数据，检查DUT在 valid_in 为低时不会误用输入
+void Simulator::drive_bubble() {
+    top_->io_valid_in = 0;
+    top_->io_a_in_32 = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    top_->io_b_in_32 = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    top_->io_a_in_16_0 = (uint16_t)rand();
+    top_->io_a_in_16_1 = (uint16_t)rand();
+    top_->io_b_in_16_0 = (uint16_t)rand();
+    top_->io_b_in_16_1 = (uint16_t)rand();
+}
+
+template <TestMode M>
+bool Simulator::issue_homogeneous(const TestCase* tests, size_t n, StreamState& st) {
+    drive_mode<M>(top_.get());
+    cur_mode_ = M;
+    eval_profile_.ops[(int)M] += n;
+    for (size_t i = 0; i < n; ++i) {
+        while (!issue_gen_.next()) {
+            drive_bubble();
+            single_cycle();
+            stream_stats_.bubbles++;
+            if (!collect_output(st)) {
+                return false;
+            }
+        }
+        drive_operands<M>(top_.get(), tests[i]);
+        top_->io_valid_in = 1;
+        single_cycle();
+        st.issue_cycles[st.issued++] = cycles_;
+        if (!collect_output(st)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Simulator::run_batch(const TestCase* tests, size_t n, DutOutputs* results, bool reset_dut) {
+    TRACE_SCOPE("Simulator::run_batch");
+    typedef bool (Simulator::*IssueFn)(const TestCase*, size_t, StreamState&);
+    static const IssueFn table[kNumTestModes] = {
+        &Simulator::issue_homogeneous<TestMode::FP32>,
+        &Simulator::issue_homogeneous<TestMode::FP16>,
+        &Simulator::issue_homogeneous<TestMode::BF16>,
+        &Simulator::issue_homogeneous<TestMode::FP16_Widen>,
+        &Simulator::issue_homogeneous<TestMode::BF16_Widen>,
+    };
+    const int timeout = 100; // 发射完成后等待 valid_out 的超时周期
+
+    if (reset_dut) {
+        reset(2);
+    }
+    issue_cycles_.resize(n);
+    StreamState st = {results, issue_cycles_.data(), 0, 0};
+    uint64_t start_cycle = cycles_;
+    size_t begin = 0;
+    while (begin < n) {
+        size_t end = begin + 1;
+        while (end < n && tests[end].mode == tests[begin].mode) end++;
+        if (begin > 0) stream_stats_.mode_switches++;
+        IssueFn fn = table[(int)tests[begin].mode];
+        if (!(this->*fn)(tests + begin, end - begin, st)) {
+            top_->io_valid_in = 0;
+            return false;
+        }
+        begin = end;
+    }
+
+    // 排空流水线
+    top_->io_valid_in = 0;
+    int idle = 0;
+    while (st.received < n) {
+        single_cycle();
+        if (top_->io_valid_out) {
+            idle = 0;
+        } else if (++idle > timeout) {
+            printf("Timeout waiting for valid_out (%zu of %zu results received)\n", st.received, n);
+            return false;
+        }
+        if (!collect_output(st)) {
+            return false;
+        }
+    }
+    stream_stats_.ops += n;
+    stream_stats_.cycles += cycles_ - start_cycle;
+    return true;
+}
+
+#ifdef COVERAGE
+const uint32_t* Simulator::coverage_counters(size_t& count) const {
+    const auto& counters = top_->rootp->vlSymsp->__Vcoverage;
+    count = sizeof(counters) / sizeof(counters[0]);
+    return counters;
+}
+
+void Simulator::write_coverage(const string& path) {
+    contextp_->coveragep()->write(path.c_str());
+}
+#endif
+
+// ===================================================================
+// 检查点 (checkpoint) 保存与恢复
+// ===================================================================
+// 文件格式: magic | version | has_model | HarnessState | 失败序号[failed] | [Verilator模型状态]
+// 先写入临时文件再 rename，避免写到一半被中断时破坏上一个检查点。
+// 使用 --savable 编译模型并定义 SAVABLE 时，模型状态会一起保存，
+// 否则只保存测试平台状态 (每个测试开始前DUT都会复位，因此仍可续跑)。
+
+bool Simulator::save_checkpoint(const string& path, HarnessState state,
+                                const vector<uint64_t>& failed_tests) {
+    state.sim_time = contextp_->time();
+    state.failed = failed_tests.size();
+    string tmp_path = path + ".tmp";
+#ifdef SAVABLE
+    const uint32_t has_model = 1;
+    VerilatedSave os;
+    os.open(tmp_path.c_str());
+    if (!os.isOpen()) {
+        printf("Cannot open checkpoint file %s\n", tmp_path.c_str());
+        return false;
+    }
+    os.write(&kCheckpointMagic, sizeof(kCheckpointMagic));
+    os.write(&kCheckpointVersion, sizeof(kCheckpointVersion));
+    os.write(&has_model, sizeof(has_model));
+    os.write(&state, sizeof(state));
+    os.write(failed_tests.data(), failed_tests.size() * sizeof(uint64_t));
+    os << *top_;
+    os.close();
+#else
+    const uint32_t has_model = 0;
+    FILE* fp = fopen(tmp_path.c_str(), "wb");
+    if (!fp) {
+        printf("Cannot open checkpoint file %s\n", tmp_path.c_str());
+        return false;
+    }
+    bool ok = fwrite(&kCheckpointMagic, sizeof(kCheckpointMagic), 1, fp) == 1
+           && fwrite(&kCheckpointVersion, sizeof(kCheckpointVersion), 1, fp) == 1
+           && fwrite(&has_model, sizeof(has_model), 1, fp) == 1
+           && fwrite(&state, sizeof(state), 1, fp) == 1
+           && fwrite(failed_tests.data(), sizeof(uint64_t), failed_tests.size(), fp) == failed_tests.size();
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok) {
+        printf("Failed to write checkpoint file %s\n", tmp_path.c_str());
+        return false;
+    }
+#endif
+    if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+        printf("Cannot rename %s to %s\n", tmp_path.c_str(), path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Simulator::restore_checkpoint(const string& path, HarnessState& state,
+                                   vector<uint64_t>& failed_tests) {
+    uint32_t magic = 0, version = 0, has_model = 0;
+#ifdef SAVABLE
+    VerilatedRestore os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+        printf("Cannot open checkpoint file %s\n", path.c_str());
+        return false;
+    }
+    os.read(&magic, sizeof(magic));
+    os.read(&version, sizeof(version));
+    os.read(&has_model, sizeof(has_model));
+    if (magic != kCheckpointMagic || version != kCheckpointVersion || !has_model) {
+        printf("Invalid checkpoint file %s\n", path.c_str());
+        return false;
+    }
+    os.read(&state, sizeof(state));
+    // 失败的测试都在 next_test 之前，否则文件已损坏
+    if (state.failed > state.next_test) {
+        printf("Invalid checkpoint file %s\n", path.c_str());
+        return false;
+    }
+    failed_tests.resize(state.failed);
+    os.read(failed_tests.data(), failed_tests.size() * sizeof(uint64_t));
+    os >> *top_;
+    os.close();
+#else
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        printf("Cannot open checkpoint file %s\n", path.c_str());
+        return false;
+    }
+    bool ok = fread(&magic, sizeof(magic), 1, fp) == 1
+           && fread(&version, sizeof(version), 1, fp) == 1
+           && fread(&has_model, sizeof(has_model), 1, fp) == 1
+           && fread(&state, sizeof(state), 1, fp) == 1;
+    // 失败的测试都在 next_test 之前，否则文件已损坏
+    ok = ok && state.failed <= state.next_test;
+    if (ok && magic == kCheckpointMagic && version == kCheckpointVersion) {
+        failed_tests.resize(state.failed);
+        ok = fread(failed_tests.data(), sizeof(uint64_t), failed_tests.size(), fp) == failed_tests.size();
+    }
+    fclose(fp);
+    if (!ok || magic != kCheckpointMagic || version != kCheckpointVersion) {
+        printf("Invalid checkpoint file %s\n", path.c_str());
+        return false;
+    }
+#endif
+    contextp_->time(state.sim_time);
+    return true;
+}
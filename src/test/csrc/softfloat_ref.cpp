@@ -1,6 +1,12 @@
 #include "include/softfloat_ref.h"
 #include "include/fp_utils.h"
 #include <cstring> // For memcpy
+#include <mutex>
+
+// With -DSOFTFLOAT_TLS, SoftFloat itself must be built with -DTHREAD_LOCAL=_Thread_local
+#ifdef SOFTFLOAT_TLS
+#define THREAD_LOCAL thread_local
+#endif
 
 extern "C" {
 #include "softfloat.h"
@@ -27,62 +33,184 @@ static inline uint16_t from_float16_t(float16_t f) {
 }
 
 // ===================================================================
-//  SoftFloat based reference functions
+//  SoftFloat state
 // ===================================================================
 
-uint32_t softfloat_add_fp32(uint32_t a, uint32_t b) {
-    // Set rounding mode to Round-to-Nearest-Even (default)
+#ifdef SOFTFLOAT_TLS
+// Per-thread state: nothing to serialize. The user-provided constructor keeps
+// the unused lock locals from triggering -Wunused-variable.
+struct SoftFloatLock {
+    SoftFloatLock() {}
+};
+#else
+static std::mutex softfloat_lock;
+struct SoftFloatLock {
+    std::lock_guard<std::mutex> guard{softfloat_lock};
+};
+#endif
+
+// Reset the state before an operation; every operation uses Round-to-Nearest-Even
+static inline void begin_op() {
     softfloat_roundingMode = softfloat_round_near_even;
-    
-    float32_t f32_a = to_float32_t(a);
-    float32_t f32_b = to_float32_t(b);
-    
-    float32_t result = f32_add(f32_a, f32_b);
-    
-    return from_float32_t(result);
+    softfloat_exceptionFlags = 0;
+}
+
+static inline uint8_t end_op() {
+    return (uint8_t)softfloat_exceptionFlags;
+}
+
+// ===================================================================
+//  Operations (callers hold SoftFloatLock)
+// ===================================================================
+
+static RefResult add_fp32(uint32_t a, uint32_t b) {
+    begin_op();
+    uint32_t r = from_float32_t(f32_add(to_float32_t(a), to_float32_t(b)));
+    return RefResult{ r, end_op() };
+}
+
+static RefResult add_fp16(uint16_t a, uint16_t b) {
+    begin_op();
+    uint16_t r = from_float16_t(f16_add(to_float16_t(a), to_float16_t(b)));
+    return RefResult{ r, end_op() };
+}
+
+// For BFloat16, we add in FP32 using SoftFloat and round the FP32 sum to BF16
+// with fp_utils (RNE). The flags of that second rounding are derived here.
+static RefResult add_bf16(uint16_t a, uint16_t b) {
+    // 1. BF16 -> FP32 is a 16-bit shift of the bit pattern
+    RefResult sum = add_fp32((uint32_t)a << 16, (uint32_t)b << 16);
+
+    // 2. Round the FP32 sum to BF16
+    float float_sum;
+    memcpy(&float_sum, &sum.bits, sizeof(uint32_t));
+    uint16_t r = fp32_to_bf16(float_sum);
+
+    // 3. Flags of the FP32 -> BF16 rounding (NaN results raise nothing new)
+    uint8_t flags = sum.flags;
+    bool nan = (sum.bits & 0x7F800000) == 0x7F800000 && (sum.bits & 0x007FFFFF);
+    if (!nan && ((uint32_t)r << 16) != sum.bits) {
+        flags |= kRefFlagNX;
+        bool inf = (r & 0x7FFF) == 0x7F80;
+        bool sum_inf = (sum.bits & 0x7FFFFFFF) == 0x7F800000;
+        if (inf && !sum_inf) flags |= kRefFlagOF;
+        if ((r & 0x7F80) == 0) flags |= kRefFlagUF; // tiny (subnormal or zero) and inexact
+    }
+    return RefResult{ r, flags };
+}
+
+static RefResult add_fp16_widen(uint16_t a, uint16_t b) {
+    // fp16_to_fp32 is exact and keeps signaling NaNs, so f32_add raises NV for them
+    float fa = fp16_to_fp32(a), fb = fp16_to_fp32(b);
+    uint32_t a32, b32;
+    memcpy(&a32, &fa, sizeof(uint32_t));
+    memcpy(&b32, &fb, sizeof(uint32_t));
+    return add_fp32(a32, b32);
+}
+
+static RefResult add_bf16_widen(uint16_t a, uint16_t b) {
+    return add_fp32((uint32_t)a << 16, (uint32_t)b << 16);
+}
+
+static RefResult add_beat(TestMode mode, uint32_t a, uint32_t b) {
+    switch (mode) {
+        case TestMode::FP32:
+            return add_fp32(a, b);
+        case TestMode::FP16:
+        case TestMode::BF16: {
+            // Two lanes: lane 0 in the low 16 bits, lane 1 in the high 16 bits
+            RefResult (*add16)(uint16_t, uint16_t) = mode == TestMode::FP16 ? add_fp16 : add_bf16;
+            RefResult r0 = add16((uint16_t)a, (uint16_t)b);
+            RefResult r1 = add16((uint16_t)(a >> 16), (uint16_t)(b >> 16));
+            return RefResult{ (r1.bits << 16) | r0.bits, (uint8_t)(r0.flags | r1.flags) };
+        }
+        case TestMode::FP16_Widen:
+            return add_fp16_widen((uint16_t)(a >> 16), (uint16_t)(b >> 16));
+        default:
+            // BF16 widen operands in the high 16 bits are already FP32 bit patterns
+            return add_fp32(a & 0xFFFF0000, b & 0xFFFF0000);
+    }
+}
+
+// ===================================================================
+//  Public entry points
+// ===================================================================
+
+RefResult reference_add_fp32(uint32_t a, uint32_t b) {
+    SoftFloatLock lock;
+    return add_fp32(a, b);
+}
+
+RefResult reference_add_fp16(uint16_t a, uint16_t b) {
+    SoftFloatLock lock;
+    return add_fp16(a, b);
+}
+
+RefResult reference_add_bf16(uint16_t a, uint16_t b) {
+    SoftFloatLock lock;
+    return add_bf16(a, b);
+}
+
+RefResult reference_add_fp16_widen(uint16_t a, uint16_t b) {
+    SoftFloatLock lock;
+    return add_fp16_widen(a, b);
+}
+
+RefResult reference_add_bf16_widen(uint16_t a, uint16_t b) {
+    SoftFloatLock lock;
+    return add_bf16_widen(a, b);
+}
+
+RefResult reference_add(TestMode mode, uint32_t a_bits, uint32_t b_bits) {
+    SoftFloatLock lock;
+    return add_beat(mode, a_bits, b_bits);
+}
+
+void reference_add_batch(TestMode mode, const uint32_t* a_bits, const uint32_t* b_bits, RefResult* out, size_t n) {
+    SoftFloatLock lock;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = add_beat(mode, a_bits[i], b_bits[i]);
+    }
+}
+
+void compute_expected_batch(TestCase* tests, size_t n, uint8_t* flags) {
+    SoftFloatLock lock;
+    for (size_t i = 0; i < n; ++i) {
+        RefResult r = add_beat(tests[i].mode, tests[i].a_bits, tests[i].b_bits);
+        tests[i].expected_bits = r.bits;
+        tests[i].expected_flags = r.flags;
+        if (flags) flags[i] = r.flags;
+    }
+}
+
+uint32_t softfloat_add_fp32(uint32_t a, uint32_t b) {
+    return reference_add_fp32(a, b).bits;
 }
 
 uint16_t softfloat_add_fp16(uint16_t a, uint16_t b) {
-    // Set rounding mode
-    softfloat_roundingMode = softfloat_round_near_even;
-    
-    float16_t f16_a = to_float16_t(a);
-    float16_t f16_b = to_float16_t(b);
-    
-    float16_t result = f16_add(f16_a, f16_b);
-    
-    return from_float16_t(result);
+    return (uint16_t)reference_add_fp16(a, b).bits;
 }
 
-// For BFloat16, we leverage the existing conversion functions in `fp_utils.h`
-// to bridge between standard types and SoftFloat types.
 uint16_t softfloat_add_bf16(uint16_t a, uint16_t b) {
-    // Set rounding mode
-    softfloat_roundingMode = softfloat_round_near_even;
+    return (uint16_t)reference_add_bf16(a, b).bits;
+}
+
+uint16_t reference_f32_to_f16(uint32_t bits) {
+    SoftFloatLock lock;
+    begin_op();
+    return from_float16_t(f32_to_f16(to_float32_t(bits)));
+}
 
-    // 1. Convert BF16 inputs (uint16_t) to standard C++ float using fp_utils
-    float float_a = bf16_to_fp32(a);
-    float float_b = bf16_to_fp32(b);
-
-    // 2. Get the bit patterns of the floats
-    uint32_t bits_a, bits_b;
-    memcpy(&bits_a, &float_a, sizeof(uint32_t));
-    memcpy(&bits_b, &float_b, sizeof(uint32_t));
-
-    // 3. Wrap bit patterns into SoftFloat types
-    float32_t f32_a = to_float32_t(bits_a);
-    float32_t f32_b = to_float32_t(bits_b);
-    
-    // 4. Perform addition in FP32 using SoftFloat
-    float32_t f32_result = f32_add(f32_a, f32_b);
-    
-    // 5. Unwrap the result bits
-    uint32_t result_bits = from_float32_t(f32_result);
-
-    // 6. Convert result bits back to a standard C++ float
-    float float_result;
-    memcpy(&float_result, &result_bits, sizeof(uint32_t));
-
-    // 7. Convert the float result back to BF16 (uint16_t) using fp_utils
-    return fp32_to_bf16(float_result);
-} 
\ No newline at end of file
+void reference_f32_to_f16_batch(const uint32_t* bits, uint16_t* out, size_t n) {
+    SoftFloatLock lock;
+    begin_op();
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = from_float16_t(f32_to_f16(to_float32_t(bits[i])));
+    }
+}
+
+uint32_t reference_f16_to_f32(uint16_t bits) {
+    SoftFloatLock lock;
+    begin_op();
+    return from_float32_t(f16_to_f32(to_float16_t(bits)));
+}
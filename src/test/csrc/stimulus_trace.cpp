@@ -0,0 +1,194 @@
+#include "include/stimulus_trace.h"
+
+#include <cstring>
+
+using namespace std;
+
+const size_t kStimulusBufferSize = 1 << 20; // 写缓冲区，满后写入文件
+const uint8_t kTagCtrl = 0x01;
+const uint8_t kTagValidOut = 0x80;
+
+template <typename T>
+static inline void put(vector<uint8_t>& buf, T v) {
+    size_t pos = buf.size();
+    buf.resize(pos + sizeof(T));
+    memcpy(buf.data() + pos, &v, sizeof(T));
+}
+
+// ===================================================================
+// StimulusWriter
+// ===================================================================
+
+bool StimulusWriter::open(const string& path) {
+    fp_ = fopen(path.c_str(), "wb");
+    if (!fp_) {
+        printf("Cannot open stimulus trace %s\n", path.c_str());
+        return false;
+    }
+    path_ = path;
+    header_ = StimulusHeader{kStimulusMagic, kStimulusVersion, 0, 0};
+    // 第一个周期与全 0 输入比较，只写出非 0 的字段
+    last_ = PortInputs{};
+    idle_ = 0;
+    ok_ = fwrite(&header_, sizeof(header_), 1, fp_) == 1;
+    buf_.reserve(kStimulusBufferSize + 64);
+    return ok_;
+}
+
+void StimulusWriter::flush_idle() {
+    if (!idle_) return;
+    buf_.push_back(0);
+    for (uint64_t n = idle_; ; n >>= 7) {
+        if (n < 0x80) {
+            buf_.push_back((uint8_t)n);
+            break;
+        }
+        buf_.push_back((uint8_t)(n & 0x7F) | 0x80);
+    }
+    idle_ = 0;
+}
+
+void StimulusWriter::flush_buffer() {
+    if (!buf_.empty()) {
+        ok_ = fwrite(buf_.data(), 1, buf_.size(), fp_) == buf_.size() && ok_;
+        buf_.clear();
+    }
+}
+
+void StimulusWriter::cycle(const PortInputs& in, const DutOutputs* out) {
+    if (!fp_) return;
+    header_.cycles++;
+    uint8_t tag = 0;
+    if (in.ctrl != last_.ctrl) tag |= kTagCtrl;
+    if (in.a_in_32 != last_.a_in_32) tag |= 0x02;
+    if (in.b_in_32 != last_.b_in_32) tag |= 0x04;
+    if (in.a_in_16[0] != last_.a_in_16[0]) tag |= 0x08;
+    if (in.a_in_16[1] != last_.a_in_16[1]) tag |= 0x10;
+    if (in.b_in_16[0] != last_.b_in_16[0]) tag |= 0x20;
+    if (in.b_in_16[1] != last_.b_in_16[1]) tag |= 0x40;
+    if (out) tag |= kTagValidOut;
+    if (!tag) {
+        idle_++;
+        return;
+    }
+    flush_idle();
+    buf_.push_back(tag);
+    if (tag & kTagCtrl) put(buf_, in.ctrl);
+    if (tag & 0x02) put(buf_, in.a_in_32);
+    if (tag & 0x04) put(buf_, in.b_in_32);
+    if (tag & 0x08) put(buf_, in.a_in_16[0]);
+    if (tag & 0x10) put(buf_, in.a_in_16[1]);
+    if (tag & 0x20) put(buf_, in.b_in_16[0]);
+    if (tag & 0x40) put(buf_, in.b_in_16[1]);
+    if (out) {
+        header_.valid_outs++;
+        put(buf_, out->res_out_32);
+        put(buf_, out->res_out_16_0);
+        put(buf_, out->res_out_16_1);
+    }
+    last_ = in;
+    if (buf_.size() >= kStimulusBufferSize) flush_buffer();
+}
+
+bool StimulusWriter::close() {
+    if (!fp_) return ok_;
+    flush_idle();
+    flush_buffer();
+    ok_ = fseek(fp_, 0, SEEK_SET) == 0 && fwrite(&header_, sizeof(header_), 1, fp_) == 1 && ok_;
+    ok_ = fclose(fp_) == 0 && ok_;
+    fp_ = nullptr;
+    if (!ok_) {
+        printf("Failed to write stimulus trace %s\n", path_.c_str());
+    }
+    return ok_;
+}
+
+// ===================================================================
+// StimulusReader
+// ===================================================================
+
+bool StimulusReader::open(const string& path) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        printf("Cannot open stimulus trace %s\n", path.c_str());
+        return false;
+    }
+    bool ok = fread(&header_, sizeof(header_), 1, fp) == 1 && header_.magic == kStimulusMagic
+           && header_.version == kStimulusVersion;
+    if (ok) {
+        // 整个文件读入内存，回放时只做解码
+        long begin = ftell(fp);
+        fseek(fp, 0, SEEK_END);
+        long end = ftell(fp);
+        fseek(fp, begin, SEEK_SET);
+        data_.resize(end > begin ? end - begin : 0);
+        ok = fread(data_.data(), 1, data_.size(), fp) == data_.size();
+    }
+    fclose(fp);
+    if (!ok) {
+        printf("Invalid stimulus trace %s\n", path.c_str());
+        return false;
+    }
+    pos_ = 0;
+    last_ = PortInputs{};
+    idle_ = 0;
+    corrupt_ = false;
+    return true;
+}
+
+template <typename T>
+bool StimulusReader::read(T& v) {
+    if (data_.size() - pos_ < sizeof(T)) {
+        corrupt_ = true;
+        return false;
+    }
+    memcpy(&v, data_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+}
+
+bool StimulusReader::next(PortInputs& in, bool& valid_out, DutOutputs& out) {
+    valid_out = false;
+    if (idle_) {
+        idle_--;
+        in = last_;
+        return true;
+    }
+    if (pos_ >= data_.size()) {
+        return false;
+    }
+    uint8_t tag = data_[pos_++];
+    if (!tag) {
+        uint64_t n = 0;
+        for (int shift = 0; ; shift += 7) {
+            uint8_t byte;
+            if (shift > 63 || !read(byte)) {
+                corrupt_ = true;
+                return false;
+            }
+            n |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        if (!n) {
+            corrupt_ = true;
+            return false;
+        }
+        idle_ = n - 1;
+        in = last_;
+        return true;
+    }
+    bool ok = true;
+    if (tag & kTagCtrl) ok = ok && read(last_.ctrl);
+    if (tag & 0x02) ok = ok && read(last_.a_in_32);
+    if (tag & 0x04) ok = ok && read(last_.b_in_32);
+    if (tag & 0x08) ok = ok && read(last_.a_in_16[0]);
+    if (tag & 0x10) ok = ok && read(last_.a_in_16[1]);
+    if (tag & 0x20) ok = ok && read(last_.b_in_16[0]);
+    if (tag & 0x40) ok = ok && read(last_.b_in_16[1]);
+    if (tag & kTagValidOut) {
+        valid_out = true;
+        ok = ok && read(out.res_out_32) && read(out.res_out_16_0) && read(out.res_out_16_1);
+    }
+    in = last_;
+    return ok;
+}
@@ -0,0 +1,143 @@
+#include "include/suite_min.h"
+#include "include/batch_check.h"
+#include "include/format_traits.h"
+#include "include/func_coverage.h"
+#include "include/vector_pack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+// RTL 覆盖点的箱编号: 最高位置1，与功能覆盖箱区分
+const uint32_t kRtlBinFlag = 0x80000000u;
+
+vector<size_t> greedy_set_cover(const CoverageSets& sets, const vector<size_t>& forced) {
+    // 箱编号压缩为连续下标
+    unordered_map<uint32_t, uint32_t> dense;
+    vector<uint32_t> ids(sets.bins.size());
+    for (size_t k = 0; k < sets.bins.size(); ++k) {
+        ids[k] = dense.emplace(sets.bins[k], (uint32_t)dense.size()).first->second;
+    }
+    vector<bool> covered(dense.size(), false);
+    vector<bool> selected(sets.size(), false);
+
+    auto gain = [&](size_t i) {
+        size_t g = 0;
+        for (size_t k = sets.offsets[i]; k < sets.offsets[i + 1]; ++k) {
+            g += !covered[ids[k]];
+        }
+        return g;
+    };
+    auto select = [&](size_t i) {
+        selected[i] = true;
+        for (size_t k = sets.offsets[i]; k < sets.offsets[i + 1]; ++k) {
+            covered[ids[k]] = true;
+        }
+    };
+
+    for (size_t i : forced) {
+        select(i);
+    }
+    // 惰性贪心: 新增覆盖只会减少，堆顶重新计算后仍不小于次大值即可选中。
+    // 新增覆盖相同时选下标较小的向量 (定向测试在前)
+    typedef pair<size_t, size_t> Entry; // (gain, ~index)
+    priority_queue<Entry> heap;
+    for (size_t i = 0; i < sets.size(); ++i) {
+        if (!selected[i]) heap.push(Entry(sets.offsets[i + 1] - sets.offsets[i], ~i));
+    }
+    while (!heap.empty()) {
+        size_t i = ~heap.top().second;
+        heap.pop();
+        size_t g = gain(i);
+        if (g == 0) continue;
+        if (heap.empty() || g >= heap.top().first) {
+            select(i);
+        } else {
+            heap.push(Entry(g, ~i));
+        }
+    }
+
+    vector<size_t> result;
+    for (size_t i = 0; i < sets.size(); ++i) {
+        if (selected[i]) result.push_back(i);
+    }
+    return result;
+}
+
+int minimize_suite(Simulator& sim, const vector<TestCase>& pool, const string& pack_path) {
+    CoverageSets sets;
+    vector<size_t> failed;
+    vector<uint32_t> bins;
+    BatchChecker checker;
+    size_t num_functional = 0, num_rtl = 0;
+
+    printf("--- Collecting coverage for %zu vectors ---\n", pool.size());
+    for (size_t i = 0; i < pool.size(); ++i) {
+        bins.clear();
+        functional_bins(pool[i], bins);
+#ifdef COVERAGE
+        size_t num_points = 0;
+        const uint32_t* counters = sim.coverage_counters(num_points);
+        vector<uint32_t> before(counters, counters + num_points);
+#endif
+        // 只在第一个向量前复位，之后DUT状态连续
+        DutOutputs out;
+        if (!sim.run_batch(&pool[i], 1, &out, i == 0)) {
+            printf("Timeout while running test case %zu\n", i + 1);
+            return 1;
+        }
+#ifdef COVERAGE
+        for (size_t p = 0; p < num_points; ++p) {
+            if (counters[p] != before[p]) bins.push_back(kRtlBinFlag | (uint32_t)p);
+        }
+#endif
+        if (!checker.fast_check(&pool[i], &out, 1).empty()) {
+            printf("--- Checking test case %zu of %zu ---\n", i + 1, pool.size());
+            pool[i].print_details();
+            if (!pool[i].check_result(out)) failed.push_back(i);
+        }
+        sort(bins.begin(), bins.end());
+        bins.erase(unique(bins.begin(), bins.end()), bins.end());
+        sets.bins.insert(sets.bins.end(), bins.begin(), bins.end());
+        sets.offsets.push_back(sets.bins.size());
+    }
+
+    vector<size_t> keep = greedy_set_cover(sets, failed);
+
+    vector<uint32_t> all_bins(sets.bins);
+    sort(all_bins.begin(), all_bins.end());
+    all_bins.erase(unique(all_bins.begin(), all_bins.end()), all_bins.end());
+    for (uint32_t bin : all_bins) {
+        (bin & kRtlBinFlag) ? num_rtl++ : num_functional++;
+    }
+
+    vector<TestCase> pack;
+    size_t before_count[kNumTestModes] = {}, after_count[kNumTestModes] = {};
+    for (const TestCase& t : pool) before_count[(int)t.mode]++;
+    for (size_t i : keep) {
+        pack.push_back(pool[i]);
+        after_count[(int)pool[i].mode]++;
+    }
+
+    printf("\n=================================\n");
+    printf("  Suite minimization\n");
+    printf("=================================\n");
+    printf("Covered: %zu functional bins, %zu RTL points\n", num_functional, num_rtl);
+    for (int m = 0; m < kNumTestModes; ++m) {
+        if (before_count[m]) {
+            printf("  %-12s %8zu -> %zu\n", test_mode_name((TestMode)m), before_count[m], after_count[m]);
+        }
+    }
+    printf("Kept %zu of %zu vectors (%zu failing)\n", pack.size(), pool.size(), failed.size());
+    printf("=================================\n");
+
+    if (!write_vector_pack(pack_path, pack)) {
+        return 1;
+    }
+    printf("Vector pack written to %s\n", pack_path.c_str());
+    return failed.empty() ? 0 : 1;
+}
@@ -0,0 +1,324 @@
+#include "include/tensor_numerics.h"
+#include "include/npy_file.h"
+#include "include/vfpu_sim.h"
+#include "include/simulator.h"
+#include "include/fp_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+const size_t kTensorChunk = 1 << 16; // 每次 vfpu_sim_add 的元素数
+
+enum class TensorFormat { FP32, FP16, BF16 };
+
+struct FormatInfo {
+    const char* name;
+    int man_bits;
+    int min_exp;  // 最小正规数的指数
+};
+
+static const FormatInfo& format_info(TensorFormat f) {
+    static const FormatInfo table[] = {
+        { "fp32", 23, -126 },
+        { "fp16", 10, -14 },
+        { "bf16", 7, -126 },
+    };
+    return table[(int)f];
+}
+
+static bool parse_format(const string& name, TensorFormat& f) {
+    if (name == "fp32") f = TensorFormat::FP32;
+    else if (name == "fp16") f = TensorFormat::FP16;
+    else if (name == "bf16") f = TensorFormat::BF16;
+    else return false;
+    return true;
+}
+
+// --npy-format 未指定时由 dtype 推断: <f4 为 FP32，<f2 为 FP16，其余2字节类型 (<V2, <u2...) 视为 BF16 位模式
+static bool tensor_format(const SimOptions& opts, const NpyArray& arr, TensorFormat& f) {
+    if (!opts.npy_format.empty()) {
+        if (!parse_format(opts.npy_format, f)) {
+            printf("Unknown tensor format: %s\n", opts.npy_format.c_str());
+            return false;
+        }
+    } else if (arr.item_size() == 4) {
+        f = TensorFormat::FP32;
+    } else {
+        f = arr.descr() == "<f2" ? TensorFormat::FP16 : TensorFormat::BF16;
+    }
+    if ((f == TensorFormat::FP32) != (arr.item_size() == 4)) {
+        printf("Format %s does not match dtype %s\n", format_info(f).name, arr.descr().c_str());
+        return false;
+    }
+    return true;
+}
+
+static double to_double(TensorFormat f, uint32_t bits) {
+    switch (f) {
+        case TensorFormat::FP16: return fp16_to_fp32((uint16_t)bits);
+        case TensorFormat::BF16: return bf16_to_fp32((uint16_t)bits);
+        default: {
+            float v;
+            memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+    }
+}
+
+static uint32_t load_bits(const void* data, size_t item_size, size_t i) {
+    if (item_size == 2) {
+        uint16_t v;
+        memcpy(&v, (const char*)data + 2 * i, 2);
+        return v;
+    }
+    uint32_t v;
+    memcpy(&v, (const char*)data + 4 * i, 4);
+    return v;
+}
+
+static vfpu_mode add_mode(TensorFormat f, bool widen) {
+    switch (f) {
+        case TensorFormat::FP16: return widen ? VFPU_MODE_FP16_WIDEN : VFPU_MODE_FP16;
+        case TensorFormat::BF16: return widen ? VFPU_MODE_BF16_WIDEN : VFPU_MODE_BF16;
+        default: return VFPU_MODE_FP32;
+    }
+}
+
+void TensorErrorStats::add(double got, double ref, int man_bits, int min_exp) {
+    if (!isfinite(got) || !isfinite(ref)) {
+        nonfinite++;
+        return;
+    }
+    values++;
+    double err = fabs(got - ref);
+    // 参考值为0或非正规数时，ulp 为该格式最小的非正规数
+    double ulp = ldexp(1.0, min_exp - man_bits);
+    if (fabs(ref) >= ldexp(1.0, min_exp)) {
+        int exp;
+        frexp(ref, &exp); // ref = m * 2^exp, 0.5 <= |m| < 1
+        ulp = ldexp(1.0, exp - 1 - man_bits);
+    }
+    max_ulp = max(max_ulp, err / ulp);
+    sum_ulp += err / ulp;
+    if (ref != 0) {
+        double rel = err / fabs(ref);
+        max_rel = max(max_rel, rel);
+        sum_rel += rel;
+        rel_values++;
+    }
+}
+
+// sim_seconds 只含模型仿真，total_seconds 另含 FP64 参考计算与误差统计
+static void print_report(const char* title, const TensorErrorStats& st, uint64_t elements, double sim_seconds,
+                         double total_seconds) {
+    printf("\n=================================\n");
+    printf("  %s\n", title);
+    printf("=================================\n");
+    printf("  input elements     %llu\n", (unsigned long long)elements);
+    printf("  elements/sec       %.0f (model only, %.3f s of %.3f s total)\n",
+           sim_seconds > 0 ? elements / sim_seconds : 0.0, sim_seconds, total_seconds);
+    printf("  results checked    %llu (%llu non-finite skipped)\n", (unsigned long long)st.values,
+           (unsigned long long)st.nonfinite);
+    printf("  max rel error      %.3e\n", st.max_rel);
+    printf("  mean rel error     %.3e\n", st.rel_values ? st.sum_rel / st.rel_values : 0.0);
+    printf("  max error          %.3f ulp\n", st.max_ulp);
+    printf("  mean error         %.3f ulp\n", st.values ? st.sum_ulp / st.values : 0.0);
+    printf("=================================\n");
+}
+
+// 逐元素 A + B
+static int run_add(const SimOptions& opts, vfpu_sim* sim) {
+    NpyArray a, b;
+    if (!a.open(opts.npy_inputs[0]) || !b.open(opts.npy_inputs[1])) return 1;
+    TensorFormat fmt;
+    if (!tensor_format(opts, a, fmt)) return 1;
+    if (a.count() != b.count() || a.item_size() != b.item_size()) {
+        printf("Tensors differ in size or dtype\n");
+        return 1;
+    }
+    const bool widen = opts.npy_widen && fmt != TensorFormat::FP32;
+    const vfpu_mode mode = add_mode(fmt, widen);
+    const TensorFormat out_fmt = widen ? TensorFormat::FP32 : fmt;
+    const size_t out_size = out_fmt == TensorFormat::FP32 ? 4 : 2;
+    const FormatInfo& info = format_info(out_fmt);
+
+    vector<uint8_t> out(kTensorChunk * out_size);
+    TensorErrorStats st;
+    chrono::steady_clock::duration sim_time{};
+    auto begin = chrono::steady_clock::now();
+    for (size_t first = 0; first < a.count(); first += kTensorChunk) {
+        size_t n = min(kTensorChunk, a.count() - first);
+        // 输入直接从映射区读取
+        const char* pa = (const char*)a.data() + first * a.item_size();
+        const char* pb = (const char*)b.data() + first * b.item_size();
+        auto sim_begin = chrono::steady_clock::now();
+        int status = vfpu_sim_add(sim, mode, pa, pb, out.data(), n);
+        sim_time += chrono::steady_clock::now() - sim_begin;
+        if (status != VFPU_OK) {
+            printf("Simulation failed at element %zu\n", first);
+            return 1;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            double ref = to_double(fmt, load_bits(pa, a.item_size(), i)) + to_double(fmt, load_bits(pb, b.item_size(), i));
+            st.add(to_double(out_fmt, load_bits(out.data(), out_size, i)), ref, info.man_bits, info.min_exp);
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    char title[256];
+    snprintf(title, sizeof(title), "Tensor add (%s, %s result)", format_info(fmt).name, info.name);
+    print_report(title, st, a.count(), chrono::duration<double>(sim_time).count(), seconds);
+    return 0;
+}
+
+// 一层树形归约: 每行 len 个值两两相加，奇数个时最后一个值直接进入下一层
+struct ReduceLevel {
+    vector<uint32_t> a, b, out;
+    vector<uint16_t> a16, b16, out16;
+};
+
+static bool reduce_level(vfpu_sim* sim, vfpu_mode mode, bool in16, bool out16, vector<uint32_t>& vals, size_t rows,
+                         size_t& len, ReduceLevel& lv) {
+    const size_t pairs = len / 2, odd = len & 1;
+    const size_t n = rows * pairs;
+    lv.a.resize(n);
+    lv.b.resize(n);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t i = 0; i < pairs; ++i) {
+            lv.a[r * pairs + i] = vals[r * len + 2 * i];
+            lv.b[r * pairs + i] = vals[r * len + 2 * i + 1];
+        }
+    }
+    lv.out.resize(n);
+    int status;
+    if (in16) {
+        lv.a16.assign(lv.a.begin(), lv.a.end());
+        lv.b16.assign(lv.b.begin(), lv.b.end());
+        if (out16) {
+            lv.out16.resize(n);
+            status = vfpu_sim_add(sim, mode, lv.a16.data(), lv.b16.data(), lv.out16.data(), n);
+            copy(lv.out16.begin(), lv.out16.end(), lv.out.begin());
+        } else {
+            status = vfpu_sim_add(sim, mode, lv.a16.data(), lv.b16.data(), lv.out.data(), n);
+        }
+    } else {
+        status = vfpu_sim_add(sim, mode, lv.a.data(), lv.b.data(), lv.out.data(), n);
+    }
+    if (status != VFPU_OK) return false;
+
+    // 压缩为下一层: 每行 pairs 个和，再加上奇数时留下的最后一个值
+    const size_t next = pairs + odd;
+    for (size_t r = 0; r < rows; ++r) {
+        uint32_t carry = vals[r * len + len - 1];
+        copy(lv.out.begin() + r * pairs, lv.out.begin() + (r + 1) * pairs, vals.begin() + r * next);
+        if (odd) vals[r * next + pairs] = carry;
+    }
+    vals.resize(rows * next);
+    len = next;
+    return true;
+}
+
+// 16 位位模式精确转换为 FP32 位模式 (Widen 归约中第一层留下的奇数元素)
+static uint32_t widen_bits(TensorFormat f, uint32_t bits) {
+    float v = (float)to_double(f, bits);
+    uint32_t out;
+    memcpy(&out, &v, sizeof(out));
+    return out;
+}
+
+// 沿最后一维的行归约
+static int run_sum(const SimOptions& opts, vfpu_sim* sim) {
+    NpyArray a;
+    if (!a.open(opts.npy_inputs[0])) return 1;
+    TensorFormat fmt;
+    if (!tensor_format(opts, a, fmt)) return 1;
+    const size_t row_len = a.row_length();
+    const size_t rows = row_len ? a.count() / row_len : 0;
+    if (rows == 0) {
+        printf("Tensor is empty\n");
+        return 1;
+    }
+    const bool widen = opts.npy_widen && fmt != TensorFormat::FP32;
+    const TensorFormat out_fmt = widen ? TensorFormat::FP32 : fmt;
+    const FormatInfo& info = format_info(out_fmt);
+
+    // 每组若干行一起归约，使每层的批次足够大
+    const size_t group = max((size_t)1, kTensorChunk / max(row_len, (size_t)1));
+    vector<uint32_t> vals;
+    ReduceLevel lv;
+    TensorErrorStats st;
+    chrono::steady_clock::duration sim_time{};
+    auto begin = chrono::steady_clock::now();
+    for (size_t r0 = 0; r0 < rows; r0 += group) {
+        size_t nrows = min(group, rows - r0);
+        vals.resize(nrows * row_len);
+        const size_t base = r0 * row_len;
+        for (size_t i = 0; i < nrows * row_len; ++i) {
+            vals[i] = load_bits(a.data(), a.item_size(), base + i);
+        }
+        size_t len = row_len;
+        bool in16 = fmt != TensorFormat::FP32;
+        while (len > 1) {
+            vfpu_mode mode = in16 ? add_mode(fmt, widen) : VFPU_MODE_FP32;
+            bool out16 = in16 && !widen;
+            bool carried = len & 1;
+            auto sim_begin = chrono::steady_clock::now();
+            bool ok = reduce_level(sim, mode, in16, out16, vals, nrows, len, lv);
+            sim_time += chrono::steady_clock::now() - sim_begin;
+            if (!ok) {
+                printf("Simulation failed in rows %zu..%zu\n", r0, r0 + nrows - 1);
+                return 1;
+            }
+            if (in16 && !out16) {
+                // 第一层之后为 FP32，奇数时留下的16位元素也转换为 FP32
+                if (carried) {
+                    for (size_t r = 0; r < nrows; ++r) {
+                        vals[r * len + len - 1] = widen_bits(fmt, vals[r * len + len - 1]);
+                    }
+                }
+                in16 = false;
+            }
+        }
+        for (size_t r = 0; r < nrows; ++r) {
+            double ref = 0;
+            for (size_t i = 0; i < row_len; ++i) {
+                ref += to_double(fmt, load_bits(a.data(), a.item_size(), base + r * row_len + i));
+            }
+            uint32_t bits = vals[r];
+            if (widen && in16) bits = widen_bits(fmt, bits); // 行长为1
+            st.add(to_double(out_fmt, bits), ref, info.man_bits, info.min_exp);
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    char title[256];
+    snprintf(title, sizeof(title), "Tensor sum over rows of %zu (%s, %s accumulation, %zu rows)", row_len,
+             format_info(fmt).name, info.name, rows);
+    print_report(title, st, a.count(), chrono::duration<double>(sim_time).count(), seconds);
+    return 0;
+}
+
+int run_tensor_numerics(const SimOptions& opts) {
+    vfpu_sim* sim = vfpu_sim_create();
+    if (!sim) {
+        printf("Cannot create the model\n");
+        return 1;
+    }
+    if (!opts.activity.prefix.empty()) {
+        Simulator* model = vfpu_sim_simulator(sim);
+        if (!model->enable_activity(opts.activity)) {
+            vfpu_sim_destroy(sim);
+            return 1;
+        }
+        model->set_activity_source(opts.npy_inputs.size() == 2 ? "npy_add" : "npy_sum");
+    }
+    int ret = opts.npy_inputs.size() == 2 ? run_add(opts, sim) : run_sum(opts, sim);
+    vfpu_sim_destroy(sim);
+    return ret;
+}
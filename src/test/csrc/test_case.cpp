@@ -1,445 +1,359 @@
 #include "include/test_case.h"
 #include "include/softfloat_ref.h"
+#include "include/format_traits.h"
+#include "include/perf_trace.h"
 #include <iostream>
 #include <bitset>
 #include <memory>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+
+const char* test_mode_name(TestMode mode) {
+    switch (mode) {
+        case TestMode::FP32:       return "fp32";
+        case TestMode::FP16:       return "fp16";
+        case TestMode::BF16:       return "bf16";
+        case TestMode::FP16_Widen: return "fp16_widen";
+        case TestMode::BF16_Widen: return "bf16_widen";
+    }
+    return "unknown";
+}
+
+bool parse_test_mode(const char* name, TestMode& mode) {
+    const TestMode modes[] = {TestMode::FP32, TestMode::FP16, TestMode::BF16,
+                              TestMode::FP16_Widen, TestMode::BF16_Widen};
+    for (TestMode m : modes) {
+        if (strcmp(name, test_mode_name(m)) == 0) {
+            mode = m;
+            return true;
+        }
+    }
+    return false;
+}
 
 // ===================================================================
 // TestCase 实现
 // ===================================================================
 // FP32 single operation constructor using hexadecimal input
 TestCase::TestCase(const FADD_Operands_Hex& ops_hex, ErrorType error_type) 
-    : mode(TestMode::FP32), 
-      error_type(error_type),
-      is_fp32(true), is_fp16(false), is_bf16(false), is_widen(false)
+    : a_bits(ops_hex.a_hex),
+      b_bits(ops_hex.b_hex),
+      mode(TestMode::FP32), 
+      error_type(error_type)
 {
-    // 直接使用16进制值
-    a_fp32_bits = ops_hex.a_hex;
-    b_fp32_bits = ops_hex.b_hex;
-
-    // 将16进制位模式转换为浮点数用于打印和计算
-    memcpy(&op_fp.a, &a_fp32_bits, sizeof(float));
-    memcpy(&op_fp.b, &b_fp32_bits, sizeof(float));
-
-    // 计算期望结果
-    expected_res_fp32 = softfloat_add_fp32(a_fp32_bits, b_fp32_bits);
+    compute_expected_if_enabled();
 }
 
 // FP16 dual operation constructor
 TestCase::TestCase(const FADD_Operands_Hex_16& op1, const FADD_Operands_Hex_16& op2, ErrorType error_type)
-    : mode(TestMode::FP16),
-      error_type(error_type),
-      is_fp32(false), is_fp16(true), is_bf16(false), is_widen(false)
+    : a_bits(((uint32_t)op2.a_hex << 16) | op1.a_hex),
+      b_bits(((uint32_t)op2.b_hex << 16) | op1.b_hex),
+      mode(TestMode::FP16),
+      error_type(error_type)
 {
-    // Convert and store bits for operand set 1
-    a1_fp16_bits = op1.a_hex;
-    b1_fp16_bits = op1.b_hex;
-
-    // Convert and store bits for operand set 2
-    a2_fp16_bits = op2.a_hex;
-    b2_fp16_bits = op2.b_hex;
-
-    // Convert FP16 hex values to FP32 for calculation
-    op1_fp.a = fp16_to_fp32(op1.a_hex);
-    op1_fp.b = fp16_to_fp32(op1.b_hex);
-    
-    op2_fp.a = fp16_to_fp32(op2.a_hex);
-    op2_fp.b = fp16_to_fp32(op2.b_hex);
-
-    // Calculate and store expected results
-    expected_res1_fp16 = softfloat_add_fp16(a1_fp16_bits, b1_fp16_bits);
-    expected_res2_fp16 = softfloat_add_fp16(a2_fp16_bits, b2_fp16_bits);
+    compute_expected_if_enabled();
 }
 
 // BF16 dual operation constructor
 TestCase::TestCase(const FADD_Operands_Hex_BF16& op1, const FADD_Operands_Hex_BF16& op2, ErrorType error_type)
-    : mode(TestMode::BF16),
-      error_type(error_type),
-      is_fp32(false), is_fp16(false), is_bf16(true), is_widen(false)
+    : a_bits(((uint32_t)op2.a_hex << 16) | op1.a_hex),
+      b_bits(((uint32_t)op2.b_hex << 16) | op1.b_hex),
+      mode(TestMode::BF16),
+      error_type(error_type)
 {
-    // Convert and store bits for operand set 1
-    a1_bf16_bits = op1.a_hex;
-    b1_bf16_bits = op1.b_hex;
-
-    // Convert and store bits for operand set 2
-    a2_bf16_bits = op2.a_hex;
-    b2_bf16_bits = op2.b_hex;
-
-    // Convert BF16 hex values to FP32 for calculation
-    op1_fp.a = bf16_to_fp32(op1.a_hex);
-    op1_fp.b = bf16_to_fp32(op1.b_hex);
-    
-    op2_fp.a = bf16_to_fp32(op2.a_hex);
-    op2_fp.b = bf16_to_fp32(op2.b_hex);
-
-    // Calculate and store expected results
-    expected_res1_bf16 = softfloat_add_bf16(a1_bf16_bits, b1_bf16_bits);
-    expected_res2_bf16 = softfloat_add_bf16(a2_bf16_bits, b2_bf16_bits);
+    compute_expected_if_enabled();
 }
 
 // FP16 widen operation constructor
 TestCase::TestCase(const FADD_Operands_FP16_Widen& ops_widen, ErrorType error_type)
-    : mode(TestMode::FP16_Widen),
-      error_type(error_type),
-      is_fp32(false), is_fp16(true), is_bf16(false), is_widen(true)
+    : a_bits(((uint32_t)ops_widen.a_hex) << 16),  // FP16 a位于高16位
+      b_bits(((uint32_t)ops_widen.b_hex) << 16),  // FP16 b位于高16位
+      mode(TestMode::FP16_Widen),
+      error_type(error_type)
 {
-    // 存储输入数据的位表示
-    a_fp32_bits = ((uint32_t)ops_widen.a_hex) << 16;  // FP16 a扩展到FP32格式 (左移16位)
-    b_fp32_bits = ((uint32_t)ops_widen.b_hex) << 16;  // FP16 b扩展到FP32格式 (左移16位)
-    
-    // 转换为浮点数用于计算
-    op_fp.a = fp16_to_fp32(ops_widen.a_hex);
-    op_fp.b = fp16_to_fp32(ops_widen.b_hex);
-    
-    // 计算期望结果 (FP32精度)
-    float a_float = fp16_to_fp32(ops_widen.a_hex);
-    float b_float = fp16_to_fp32(ops_widen.b_hex);
-    uint32_t a_fp32, b_fp32;
-    memcpy(&a_fp32, &a_float, sizeof(uint32_t));
-    memcpy(&b_fp32, &b_float, sizeof(uint32_t));
-    expected_res_fp32 = softfloat_add_fp32(a_fp32, b_fp32);
+    compute_expected_if_enabled();
 }
 
 // BF16 widen operation constructor
 TestCase::TestCase(const FADD_Operands_BF16_Widen& ops_widen, ErrorType error_type)
-    : mode(TestMode::BF16_Widen),
-      error_type(error_type),
-      is_fp32(false), is_fp16(false), is_bf16(true), is_widen(true)
+    : a_bits(((uint32_t)ops_widen.a_hex) << 16),  // BF16 a位于高16位
+      b_bits(((uint32_t)ops_widen.b_hex) << 16),  // BF16 b位于高16位
+      mode(TestMode::BF16_Widen),
+      error_type(error_type)
 {
-    // 存储输入数据的位表示
-    a_fp32_bits = ((uint32_t)ops_widen.a_hex) << 16;  // BF16 a扩展到FP32格式 (左移16位)
-    b_fp32_bits = ((uint32_t)ops_widen.b_hex) << 16;  // BF16 b扩展到FP32格式 (左移16位)
-    
-    // 转换为浮点数用于计算
-    op_fp.a = bf16_to_fp32(ops_widen.a_hex);
-    op_fp.b = bf16_to_fp32(ops_widen.b_hex);
-    
-    // 计算期望结果 (FP32精度)
-    float a_float = bf16_to_fp32(ops_widen.a_hex);
-    float b_float = bf16_to_fp32(ops_widen.b_hex);
-    uint32_t a_fp32, b_fp32;
-    memcpy(&a_fp32, &a_float, sizeof(uint32_t));
-    memcpy(&b_fp32, &b_float, sizeof(uint32_t));
-    expected_res_fp32 = softfloat_add_fp32(a_fp32, b_fp32);
+    compute_expected_if_enabled();
+}
+
+// 期望结果由 SoftFloat 参考模型计算，签名模式下可以关闭 (见 set_reference_enabled)
+static bool reference_enabled = true;
+
+void set_reference_enabled(bool enabled) {
+    reference_enabled = enabled;
+}
+
+void TestCase::compute_expected_if_enabled() {
+    if (reference_enabled) {
+        compute_expected();
+    } else {
+        expected_bits = 0;
+        expected_flags = 0;
+    }
+}
+
+void TestCase::compute_expected() {
+    TRACE_HOT_SCOPE("TestCase::compute_expected");
+    RefResult r = reference_add(mode, a_bits, b_bits);
+    expected_bits = r.bits;
+    expected_flags = r.flags;
+}
+
+float TestCase::f16_value(uint16_t bits) const {
+    return is_fp16() ? fp16_to_fp32(bits) : bf16_to_fp32(bits);
+}
+
+static float bits_to_fp32(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof(float));
+    return f;
 }
 
 void TestCase::print_details() const {
+    TRACE_HOT_SCOPE("TestCase::print_details");
     printf("--- Test Case ---\n");
     switch(mode) {
         case TestMode::FP32:
             printf("Mode: FP32 Single (Hex Input)\n");
             printf("Inputs (HEX): a=0x%08X, b=0x%08X\n", 
-                   a_fp32_bits, b_fp32_bits);
+                   a_bits, b_bits);
             printf("Inputs (FP):  a=%.8f, b=%.8f\n", 
-                   op_fp.a, op_fp.b);
-            float expected_fp;
-            memcpy(&expected_fp, &expected_res_fp32, sizeof(float));
-            printf("Expected: %.8f (HEX: 0x%08X)\n", expected_fp, expected_res_fp32);
+                   bits_to_fp32(a_bits), bits_to_fp32(b_bits));
+            printf("Expected: %.8f (HEX: 0x%08X)\n", bits_to_fp32(expected_bits), expected_bits);
             break;
         case TestMode::FP16:
-            printf("Mode: FP16 Dual\n");
-            printf("Inputs OP1: a=%.8f (0x%x), b=%.8f (0x%x)\n", 
-                   op1_fp.a, a1_fp16_bits, 
-                   op1_fp.b, b1_fp16_bits);
-            printf("Inputs OP2: a=%.8f (0x%x), b=%.8f (0x%x)\n", 
-                   op2_fp.a, a2_fp16_bits, 
-                   op2_fp.b, b2_fp16_bits);
-            printf("Expected1: %.8f (HEX: 0x%x)\n", fp16_to_fp32(expected_res1_fp16), expected_res1_fp16);
-            printf("Expected2: %.8f (HEX: 0x%x)\n", fp16_to_fp32(expected_res2_fp16), expected_res2_fp16);
-            break;
         case TestMode::BF16:
-            printf("Mode: BF16 Dual\n");
+            printf(mode == TestMode::FP16 ? "Mode: FP16 Dual\n" : "Mode: BF16 Dual\n");
             printf("Inputs OP1: a=%.8f (0x%x), b=%.8f (0x%x)\n", 
-                   op1_fp.a, a1_bf16_bits, 
-                   op1_fp.b, b1_bf16_bits);
+                   f16_value(a16(0)), a16(0), 
+                   f16_value(b16(0)), b16(0));
             printf("Inputs OP2: a=%.8f (0x%x), b=%.8f (0x%x)\n", 
-                   op2_fp.a, a2_bf16_bits, 
-                   op2_fp.b, b2_bf16_bits);
-            printf("Expected1: %.8f (HEX: 0x%x)\n", bf16_to_fp32(expected_res1_bf16), expected_res1_bf16);
-            printf("Expected2: %.8f (HEX: 0x%x)\n", bf16_to_fp32(expected_res2_bf16), expected_res2_bf16);
+                   f16_value(a16(1)), a16(1), 
+                   f16_value(b16(1)), b16(1));
+            printf("Expected1: %.8f (HEX: 0x%x)\n", f16_value(expected16(0)), expected16(0));
+            printf("Expected2: %.8f (HEX: 0x%x)\n", f16_value(expected16(1)), expected16(1));
             break;
         case TestMode::FP16_Widen:
-            printf("Mode: FP16 Widen (a,b=FP16, result=FP32)\n");
-            printf("Inputs: a=%.8f (FP16: 0x%04x), b=%.8f (FP16: 0x%04x)\n", 
-                   op_fp.a, (uint16_t)(a_fp32_bits >> 16),
-                   op_fp.b, (uint16_t)(b_fp32_bits >> 16));
-            float expected_fp_widen;
-            memcpy(&expected_fp_widen, &expected_res_fp32, sizeof(float));
-            printf("Expected: %.8f (HEX: 0x%08X)\n", expected_fp_widen, expected_res_fp32);
-            break;
         case TestMode::BF16_Widen:
-            printf("Mode: BF16 Widen (a,b=BF16, result=FP32)\n");
-            printf("Inputs: a=%.8f (BF16: 0x%04x), b=%.8f (BF16: 0x%04x)\n", 
-                   op_fp.a, (uint16_t)(a_fp32_bits >> 16),
-                   op_fp.b, (uint16_t)(b_fp32_bits >> 16));
-            float expected_fp_widen_bf16;
-            memcpy(&expected_fp_widen_bf16, &expected_res_fp32, sizeof(float));
-            printf("Expected: %.8f (HEX: 0x%08X)\n", expected_fp_widen_bf16, expected_res_fp32);
+            if (mode == TestMode::FP16_Widen) {
+                printf("Mode: FP16 Widen (a,b=FP16, result=FP32)\n");
+                printf("Inputs: a=%.8f (FP16: 0x%04x), b=%.8f (FP16: 0x%04x)\n", 
+                       f16_value(a16(1)), a16(1),
+                       f16_value(b16(1)), b16(1));
+            } else {
+                printf("Mode: BF16 Widen (a,b=BF16, result=FP32)\n");
+                printf("Inputs: a=%.8f (BF16: 0x%04x), b=%.8f (BF16: 0x%04x)\n", 
+                       f16_value(a16(1)), a16(1),
+                       f16_value(b16(1)), b16(1));
+            }
+            printf("Expected: %.8f (HEX: 0x%08X)\n", bits_to_fp32(expected_bits), expected_bits);
             break;
     }
 }
 
-bool TestCase::check_result(const DutOutputs& dut_res) const {
-    printf("--- Verification ---\n");
-    
-    // 辅助函数：检查两个FP32数是否都是零（忽略符号位）
-    auto both_fp32_zero = [](uint32_t a, uint32_t b) {
-        return ((a & 0x7FFFFFFF) == 0) && ((b & 0x7FFFFFFF) == 0);
-    };
-    
-    // 辅助函数：检查两个FP/BF16数是否都是零（忽略符号位）
-    auto both_f16_zero = [](uint16_t a, uint16_t b) {
-        return ((a & 0x7FFF) == 0) && ((b & 0x7FFF) == 0);
-    };
+// ===================================================================
+// 结果检查: 按 (TestMode, ErrorType) 在编译期特化
+// ===================================================================
+
+// 辅助函数：检查两个数是否都是零（忽略符号位）
+template <class Fmt>
+static inline bool both_zero(typename Fmt::bits_t a, typename Fmt::bits_t b) {
+    return ((a & Fmt::abs_mask) == 0) && ((b & Fmt::abs_mask) == 0);
+}
+
+// 相对误差是否在允许范围内 (若ab的绝对值太小，则放宽误差要求)
+template <class Fmt>
+static inline bool rel_error_ok(float max_abs, float relative_error) {
+    return (max_abs < Fmt::rel_small_abs)
+           ? (relative_error < Fmt::rel_small_limit)
+           : (relative_error < Fmt::rel_limit);
+}
+
+// FP32 单精度结果检查
+template <ErrorType E>
+static bool check_fp32(const TestCase& t, const DutOutputs& dut_res) {
+    typedef Fp32Format Fmt;
+    float dut_res_fp = Fmt::to_fp32(dut_res.res_out_32);
+    printf("DUT Result: %.8f (HEX: 0x%08X)\n", dut_res_fp, dut_res.res_out_32);
+    float expected_fp = Fmt::to_fp32(t.expected_bits);
+    int64_t ulp_diff = std::abs((int64_t)dut_res.res_out_32 - (int64_t)t.expected_bits);
+    float relative_error = 0;
+
+    bool precise_pass = (dut_res.res_out_32 == t.expected_bits);
     
-    bool pass = false;
-    switch(mode) {
-        case TestMode::FP32: {
-            float dut_res_fp;
-            memcpy(&dut_res_fp, &dut_res.res_out_32, sizeof(float));
-            printf("DUT Result: %.8f (HEX: 0x%08X)\n", dut_res_fp, dut_res.res_out_32);
-            float expected_fp;
-            memcpy(&expected_fp, &expected_res_fp32, sizeof(float));
-            int64_t ulp_diff = 0;
-            float relative_error = 0;
+    // 如果两个数都是0（忽略符号位），认为通过
+    bool zero = both_zero<Fmt>(dut_res.res_out_32, t.expected_bits);
+    bool ulp_pass = (ulp_diff <= Fmt::ulp_limit) || zero; // 允许8 ulp (unit in the last place) 的误差
+    bool rel_pass = false;
+    if (E == ErrorType::RelativeError) {
+        float max_abs = std::max(std::abs(Fmt::to_fp32(t.a_bits)), std::abs(Fmt::to_fp32(t.b_bits)));
+        relative_error = std::abs(dut_res_fp - expected_fp) / max_abs;
+        rel_pass = rel_error_ok<Fmt>(max_abs, relative_error) || precise_pass || zero;
+    }
 
-            bool precise_pass = (dut_res.res_out_32 == expected_res_fp32);
-            
-            // 如果两个数都是0（忽略符号位），认为通过
-            bool both_zero = both_fp32_zero(dut_res.res_out_32, expected_res_fp32);
-            
-            if (error_type == ErrorType::Precise) {
-                pass = precise_pass || both_zero;
-            }
-            if (error_type == ErrorType::ULP) {
-                // 允许8 ulp (unit in the last place) 的误差
-                ulp_diff = std::abs((int64_t)dut_res.res_out_32 - (int64_t)expected_res_fp32);
-                pass = (ulp_diff <= 8) || both_zero;
-            }
-            if (error_type == ErrorType::RelativeError) {
-                float max_abs = std::max(std::abs(op_fp.a), std::abs(op_fp.b));
-                relative_error = std::abs(dut_res_fp - expected_fp) / max_abs;
-                pass = ((max_abs < std::pow(2, -60)) 
-                       ? (relative_error < 1e-3) //若ab或c的绝对值太小，则放宽误差要求
-                       : (relative_error < 1e-5)) 
-                       || precise_pass || both_zero;
-            }
+    bool pass = false;
+    switch (E) {
+        case ErrorType::Precise:
+            pass = precise_pass || zero;
             if (!pass) {
-                if (error_type == ErrorType::Precise) {
-                    printf("ERROR: Expected 0x%08X, Got 0x%08X (Exact match required)\n", 
-                           expected_res_fp32, dut_res.res_out_32);
-                }
-                if (error_type == ErrorType::ULP) {
-                    printf("ERROR: Expected 0x%08X, Got 0x%08X, ULP diff: %ld\n", 
-                           expected_res_fp32, dut_res.res_out_32, ulp_diff);
-                }
-                if (error_type == ErrorType::RelativeError) {
-                    printf("ERROR: Expected 0x%08X, Got 0x%08X, Relative Error: %f\n", 
-                           expected_res_fp32, dut_res.res_out_32, relative_error);
-                }
-            }
-            if (error_type == ErrorType::ULP) {
-                printf("ULP diff: %ld\n", ulp_diff);
-            }
-            if (error_type == ErrorType::RelativeError) {
-                printf("Relative diff ratio: %.8e\n", relative_error);
+                printf("ERROR: Expected 0x%08X, Got 0x%08X (Exact match required)\n", 
+                       t.expected_bits, dut_res.res_out_32);
             }
             break;
-        }
-        case TestMode::FP16: {
-            printf("DUT Result1: %.4f (HEX: 0x%x)\n", fp16_to_fp32(dut_res.res_out_16_0), dut_res.res_out_16_0);
-            printf("DUT Result2: %.4f (HEX: 0x%x)\n", fp16_to_fp32(dut_res.res_out_16_1), dut_res.res_out_16_1);
-
-            bool pass1 = false, pass2 = false;
-            
-            // 检查两个数是否都是0（忽略符号位）
-            bool both_zero1 = both_f16_zero(dut_res.res_out_16_0, expected_res1_fp16);
-            bool both_zero2 = both_f16_zero(dut_res.res_out_16_1, expected_res2_fp16);
-            
-            if (error_type == ErrorType::Precise) {
-                // 精确匹配
-                pass1 = (dut_res.res_out_16_0 == expected_res1_fp16) || both_zero1;
-                pass2 = (dut_res.res_out_16_1 == expected_res2_fp16) || both_zero2;
-            } else if (error_type == ErrorType::ULP) {
-                // 允许ULP误差（FP16允许2 ULP误差）
-                int32_t ulp_diff1 = std::abs((int32_t)dut_res.res_out_16_0 - (int32_t)expected_res1_fp16);
-                int32_t ulp_diff2 = std::abs((int32_t)dut_res.res_out_16_1 - (int32_t)expected_res2_fp16);
-                pass1 = (ulp_diff1 <= 5) || both_zero1;
-                pass2 = (ulp_diff2 <= 5) || both_zero2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
-                           expected_res1_fp16, dut_res.res_out_16_0, ulp_diff1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
-                           expected_res2_fp16, dut_res.res_out_16_1, ulp_diff2);
-                }
-                printf("ULP diff1: %d, ULP diff2: %d\n", ulp_diff1, ulp_diff2);
-            } else if (error_type == ErrorType::RelativeError) {
-                // 相对误差检查（FP16）
-                float dut_res1_fp = fp16_to_fp32(dut_res.res_out_16_0);
-                float dut_res2_fp = fp16_to_fp32(dut_res.res_out_16_1);
-                float expected1_fp = fp16_to_fp32(expected_res1_fp16);
-                float expected2_fp = fp16_to_fp32(expected_res2_fp16);
-                
-                // 计算操作数1的相对误差
-                float max_abs1 = std::max(std::abs(op1_fp.a), std::abs(op1_fp.b));
-                float relative_error1 = std::abs(dut_res1_fp - expected1_fp) / max_abs1;
-                bool precise_pass1 = (dut_res.res_out_16_0 == expected_res1_fp16);
-                pass1 = ((max_abs1 < std::pow(2, -10))  // FP16精度较低，调整阈值
-                        ? (relative_error1 < 1e-2)      // 若ab或c的绝对值太小，则放宽误差要求
-                        : (relative_error1 < 1e-3))     // FP16相对误差要求比FP32宽松
-                        || precise_pass1 || both_zero1;
-                
-                // 计算操作数2的相对误差
-                float max_abs2 = std::max(std::abs(op2_fp.a), std::abs(op2_fp.b));
-                float relative_error2 = std::abs(dut_res2_fp - expected2_fp) / max_abs2;
-                bool precise_pass2 = (dut_res.res_out_16_1 == expected_res2_fp16);
-                pass2 = ((max_abs2 < std::pow(2, -10))  // FP16精度较低，调整阈值
-                        ? (relative_error2 < 1e-2)      // 若ab或c的绝对值太小，则放宽误差要求
-                        : (relative_error2 < 1e-3))     // FP16相对误差要求比FP32宽松
-                        || precise_pass2 || both_zero2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
-                           expected_res1_fp16, expected1_fp, dut_res.res_out_16_0, dut_res1_fp, relative_error1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
-                           expected_res2_fp16, expected2_fp, dut_res.res_out_16_1, dut_res2_fp, relative_error2);
-                }
-                printf("Relative error1: %.6e, Relative error2: %.6e\n", relative_error1, relative_error2);
+        case ErrorType::ULP:
+            pass = ulp_pass;
+            if (!pass) {
+                printf("ERROR: Expected 0x%08X, Got 0x%08X, ULP diff: %ld\n", 
+                       t.expected_bits, dut_res.res_out_32, (long)ulp_diff);
             }
-            
-            pass = pass1 && pass2;
+            printf("ULP diff: %ld\n", (long)ulp_diff);
             break;
-        }
-        case TestMode::BF16: {
-            printf("DUT Result1: %.4f (HEX: 0x%x)\n", bf16_to_fp32(dut_res.res_out_16_0), dut_res.res_out_16_0);
-            printf("DUT Result2: %.4f (HEX: 0x%x)\n", bf16_to_fp32(dut_res.res_out_16_1), dut_res.res_out_16_1);
-
-            bool pass1 = false, pass2 = false;
-            
-            // 检查两个数是否都是0（忽略符号位）
-            bool both_zero1 = both_f16_zero(dut_res.res_out_16_0, expected_res1_bf16);
-            bool both_zero2 = both_f16_zero(dut_res.res_out_16_1, expected_res2_bf16);
-            
-            // 先计算ULP和RelativeError下的通过情况
-            bool ulp_pass1 = false, ulp_pass2 = false;
-            bool rel_pass1 = false, rel_pass2 = false;
-            
-            // ULP误差计算（BF16允许2 ULP误差）
-            int32_t ulp_diff1 = std::abs((int32_t)dut_res.res_out_16_0 - (int32_t)expected_res1_bf16);
-            int32_t ulp_diff2 = std::abs((int32_t)dut_res.res_out_16_1 - (int32_t)expected_res2_bf16);
-            ulp_pass1 = (ulp_diff1 <= 2) || both_zero1;
-            ulp_pass2 = (ulp_diff2 <= 2) || both_zero2;
-            
-            // 相对误差计算（BF16）
-            float dut_res1_fp = bf16_to_fp32(dut_res.res_out_16_0);
-            float dut_res2_fp = bf16_to_fp32(dut_res.res_out_16_1);
-            float expected1_fp = bf16_to_fp32(expected_res1_bf16);
-            float expected2_fp = bf16_to_fp32(expected_res2_bf16);
-            
-            // 计算操作数1的相对误差
-            float max_abs1 = std::max(std::abs(op1_fp.a), std::abs(op1_fp.b));
-            float relative_error1 = std::abs(dut_res1_fp - expected1_fp) / max_abs1;
-            bool precise_pass1 = (dut_res.res_out_16_0 == expected_res1_bf16);
-            rel_pass1 = ((max_abs1 < std::pow(2, -30))  // BF16有较好的指数范围，但尾数精度较低
-                    ? (relative_error1 < 1e-2)      // 若ab或c的绝对值太小，则放宽误差要求
-                    : (relative_error1 < 8e-3))     // BF16相对误差要求介于FP32和FP16之间
-                    || precise_pass1 || both_zero1;
-            
-            // 计算操作数2的相对误差
-            float max_abs2 = std::max(std::abs(op2_fp.a), std::abs(op2_fp.b));
-            float relative_error2 = std::abs(dut_res2_fp - expected2_fp) / max_abs2;
-            bool precise_pass2 = (dut_res.res_out_16_1 == expected_res2_bf16);
-            rel_pass2 = ((max_abs2 < std::pow(2, -30))  // BF16有较好的指数范围，但尾数精度较低
-                    ? (relative_error2 < 1e-2)      // 若ab或c的绝对值太小，则放宽误差要求
-                    : (relative_error2 < 8e-3))     // BF16相对误差要求介于FP32和FP16之间
-                    || precise_pass2 || both_zero2;
-            
-            // 根据错误类型决定最终的通过条件
-            if (error_type == ErrorType::Precise) {
-                // 精确匹配
-                pass1 = (dut_res.res_out_16_0 == expected_res1_bf16) || both_zero1;
-                pass2 = (dut_res.res_out_16_1 == expected_res2_bf16) || both_zero2;
-            } else if (error_type == ErrorType::ULP) {
-                // 只使用ULP误差
-                pass1 = ulp_pass1;
-                pass2 = ulp_pass2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
-                           expected_res1_bf16, dut_res.res_out_16_0, ulp_diff1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
-                           expected_res2_bf16, dut_res.res_out_16_1, ulp_diff2);
-                }
-                printf("ULP diff1: %d, ULP diff2: %d\n", ulp_diff1, ulp_diff2);
-            } else if (error_type == ErrorType::RelativeError) {
-                // 只使用相对误差
-                pass1 = rel_pass1;
-                pass2 = rel_pass2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
-                           expected_res1_bf16, expected1_fp, dut_res.res_out_16_0, dut_res1_fp, relative_error1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
-                           expected_res2_bf16, expected2_fp, dut_res.res_out_16_1, dut_res2_fp, relative_error2);
-                }
-                printf("Relative error1: %.6e, Relative error2: %.6e\n", relative_error1, relative_error2);
-            } else if (error_type == ErrorType::ULP_or_RelativeError) {
-                // ULP或相对误差：如果ULP通过则通过，否则如果相对误差通过则通过，否则不通过
-                pass1 = ulp_pass1 || rel_pass1;
-                pass2 = ulp_pass2 || rel_pass2;
-                
-                if (!pass1) {
-                    printf("ERROR OP1: ULP diff: %d (>2), Relative Error: %e (>8e-3)\n", ulp_diff1, relative_error1);
-                }
-                if (!pass2) {
-                    printf("ERROR OP2: ULP diff: %d (>2), Relative Error: %e (>8e-3)\n", ulp_diff2, relative_error2);
-                }
-                printf("ULP diff1: %d, ULP diff2: %d\n", ulp_diff1, ulp_diff2);
-                printf("Relative error1: %.6e, Relative error2: %.6e\n", relative_error1, relative_error2);
+        case ErrorType::RelativeError:
+            pass = rel_pass;
+            if (!pass) {
+                printf("ERROR: Expected 0x%08X, Got 0x%08X, Relative Error: %f\n", 
+                       t.expected_bits, dut_res.res_out_32, relative_error);
             }
-            
-            pass = pass1 && pass2;
+            printf("Relative diff ratio: %.8e\n", relative_error);
             break;
-        }
-        case TestMode::FP16_Widen:
-        case TestMode::BF16_Widen:
-        {
-            float dut_res_fp;
-            memcpy(&dut_res_fp, &dut_res.res_out_32, sizeof(float));
-            printf("DUT Result: %.8f (HEX: 0x%08X)\n", dut_res_fp, dut_res.res_out_32);
-            
-            float expected_fp;
-            memcpy(&expected_fp, &expected_res_fp32, sizeof(float));
-            
-            int64_t ulp_diff = std::abs((int64_t)dut_res.res_out_32 - (int64_t)expected_res_fp32);
-            bool both_zero = both_fp32_zero(dut_res.res_out_32, expected_res_fp32);
+        case ErrorType::ULP_or_RelativeError:
+            break; // 没有该判定规则，见 has_check_rule
+    }
+    return pass;
+}
 
-            if (error_type == ErrorType::Precise) {
-                pass = (dut_res.res_out_32 == expected_res_fp32) || both_zero;
-            } else {
-                pass = (ulp_diff <= 2) || both_zero; // Widen to FP32, allow small ULP error
-            }
+// FP16/BF16 双路结果检查
+template <TestMode M, ErrorType E>
+static bool check_dual16(const TestCase& t, const DutOutputs& dut_res) {
+    typedef typename ModeTraits<M>::in_format Fmt;
+    const bool rule = has_check_rule<M>(E);
+    printf("DUT Result1: %.4f (HEX: 0x%x)\n", Fmt::to_fp32(dut_res.res_out_16_0), dut_res.res_out_16_0);
+    printf("DUT Result2: %.4f (HEX: 0x%x)\n", Fmt::to_fp32(dut_res.res_out_16_1), dut_res.res_out_16_1);
 
-            if (!pass) {
-                printf("ERROR: Expected 0x%08X, Got 0x%08X, ULP diff: %ld\n", 
-                       expected_res_fp32, dut_res.res_out_32, ulp_diff);
-            }
-            printf("ULP diff: %ld\n", ulp_diff);
-            break;
+    const uint16_t dut[2] = {dut_res.res_out_16_0, dut_res.res_out_16_1};
+    bool pass_lane[2];
+    int32_t ulp_diff[2];
+    float relative_error[2] = {0, 0};
+    float dut_fp[2] = {0, 0}, expected_fp[2] = {0, 0};
+
+    for (int lane = 0; lane < 2; ++lane) {
+        uint16_t expected = t.expected16(lane);
+        // 检查两个数是否都是0（忽略符号位）
+        bool zero = both_zero<Fmt>(dut[lane], expected);
+        bool precise_pass = (dut[lane] == expected);
+        ulp_diff[lane] = std::abs((int32_t)dut[lane] - (int32_t)expected);
+        bool ulp_pass = (ulp_diff[lane] <= Fmt::ulp_limit) || zero;
+        bool rel_pass = false;
+        if (E == ErrorType::RelativeError || (E == ErrorType::ULP_or_RelativeError && rule)) {
+            dut_fp[lane] = Fmt::to_fp32(dut[lane]);
+            expected_fp[lane] = Fmt::to_fp32(expected);
+            float max_abs = std::max(std::abs(Fmt::to_fp32(t.a16(lane))), std::abs(Fmt::to_fp32(t.b16(lane))));
+            relative_error[lane] = std::abs(dut_fp[lane] - expected_fp[lane]) / max_abs;
+            rel_pass = rel_error_ok<Fmt>(max_abs, relative_error[lane]) || precise_pass || zero;
+        }
+        switch (E) {
+            case ErrorType::Precise:              pass_lane[lane] = precise_pass || zero; break;
+            case ErrorType::ULP:                  pass_lane[lane] = ulp_pass; break;
+            case ErrorType::RelativeError:        pass_lane[lane] = rel_pass; break;
+            case ErrorType::ULP_or_RelativeError: pass_lane[lane] = rule && (ulp_pass || rel_pass); break;
         }
     }
+
+    for (int lane = 0; lane < 2; ++lane) {
+        if (pass_lane[lane]) continue;
+        if (E == ErrorType::ULP) {
+            printf("ERROR OP%d: Expected 0x%x, Got 0x%x, ULP diff: %d\n", 
+                   lane + 1, t.expected16(lane), dut[lane], ulp_diff[lane]);
+        } else if (E == ErrorType::RelativeError) {
+            printf("ERROR OP%d: Expected 0x%x (%.4f), Got 0x%x (%.4f), Relative Error: %e\n", 
+                   lane + 1, t.expected16(lane), expected_fp[lane], dut[lane], dut_fp[lane], relative_error[lane]);
+        } else if (E == ErrorType::ULP_or_RelativeError && rule) {
+            printf("ERROR OP%d: ULP diff: %d (>%d), Relative Error: %e (>%s)\n",
+                   lane + 1, ulp_diff[lane], Fmt::ulp_limit, relative_error[lane], Fmt::rel_limit_text);
+        }
+    }
+    if (E == ErrorType::ULP || (E == ErrorType::ULP_or_RelativeError && rule)) {
+        printf("ULP diff1: %d, ULP diff2: %d\n", ulp_diff[0], ulp_diff[1]);
+    }
+    if (E == ErrorType::RelativeError || (E == ErrorType::ULP_or_RelativeError && rule)) {
+        printf("Relative error1: %.6e, Relative error2: %.6e\n", relative_error[0], relative_error[1]);
+    }
+    return pass_lane[0] && pass_lane[1];
+}
+
+// FP16/BF16 Widen (结果为FP32) 检查: 除 Precise 外均按 ULP 检查
+template <ErrorType E>
+static bool check_widen(const TestCase& t, const DutOutputs& dut_res) {
+    typedef WidenFp32Format Fmt;
+    float dut_res_fp = Fmt::to_fp32(dut_res.res_out_32);
+    printf("DUT Result: %.8f (HEX: 0x%08X)\n", dut_res_fp, dut_res.res_out_32);
     
+    int64_t ulp_diff = std::abs((int64_t)dut_res.res_out_32 - (int64_t)t.expected_bits);
+    bool zero = both_zero<Fmt>(dut_res.res_out_32, t.expected_bits);
+
+    bool pass;
+    if (E == ErrorType::Precise) {
+        pass = (dut_res.res_out_32 == t.expected_bits) || zero;
+    } else {
+        pass = (ulp_diff <= Fmt::ulp_limit) || zero; // Widen to FP32, allow small ULP error
+    }
+
+    if (!pass) {
+        printf("ERROR: Expected 0x%08X, Got 0x%08X, ULP diff: %ld\n", 
+               t.expected_bits, dut_res.res_out_32, (long)ulp_diff);
+    }
+    printf("ULP diff: %ld\n", (long)ulp_diff);
+    return pass;
+}
+
+template <TestMode M, ErrorType E>
+static bool check_mode(const TestCase& t, const DutOutputs& dut_res) {
+    typedef ModeTraits<M> T;
+    if (T::is_fp32) {
+        return check_fp32<E>(t, dut_res);
+    } else if (T::is_widen) {
+        return check_widen<E>(t, dut_res);
+    } else {
+        return check_dual16<M, E>(t, dut_res);
+    }
+}
+
+template <TestMode M>
+static constexpr CheckFn check_row(ErrorType e) {
+    return e == ErrorType::Precise       ? &check_mode<M, ErrorType::Precise>
+         : e == ErrorType::ULP           ? &check_mode<M, ErrorType::ULP>
+         : e == ErrorType::RelativeError ? &check_mode<M, ErrorType::RelativeError>
+         :                                 &check_mode<M, ErrorType::ULP_or_RelativeError>;
+}
+
+CheckFn check_function(TestMode mode, ErrorType error_type) {
+    // [TestMode][ErrorType] 分发表，只在首次使用时构建一次
+    static const CheckFn table[kNumTestModes][kNumErrorTypes] = {
+#define CHECK_ROW(M) { check_row<M>(ErrorType::Precise), check_row<M>(ErrorType::ULP), \
+                       check_row<M>(ErrorType::RelativeError), check_row<M>(ErrorType::ULP_or_RelativeError) }
+        CHECK_ROW(TestMode::FP32),
+        CHECK_ROW(TestMode::FP16),
+        CHECK_ROW(TestMode::BF16),
+        CHECK_ROW(TestMode::FP16_Widen),
+        CHECK_ROW(TestMode::BF16_Widen),
+#undef CHECK_ROW
+    };
+    return table[(int)mode][(int)error_type];
+}
+
+bool TestCase::check_result(const DutOutputs& dut_res) const {
+    TRACE_HOT_SCOPE("TestCase::check_result");
+    printf("--- Verification ---\n");
+    bool pass = check_function(mode, error_type)(*this, dut_res);
     if (pass) {
         printf("Result: PASS\n");
     } else {
@@ -447,4 +361,4 @@ bool TestCase::check_result(const DutOutputs& dut_res) const {
     }
     printf("-----------------\n\n");
     return pass;
-} 
\ No newline at end of file
+}
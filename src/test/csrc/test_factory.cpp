@@ -1,37 +1,141 @@
 #include "include/test_factory.h"
 #include "include/fp_utils.h"
+#include "include/perf_trace.h"
 
 #include <vector>
 #include <cstdio>
 
-std::vector<TestCase> create_all_tests() {
+std::string selection_modes(const TestSelection& sel) {
+    std::string modes;
+    auto add = [&](bool on, TestMode mode) {
+        if (!on) return;
+        if (!modes.empty()) modes += ",";
+        modes += test_mode_name(mode);
+    };
+    add(sel.test_fp32, TestMode::FP32);
+    add(sel.test_fp16, TestMode::FP16);
+    add(sel.test_bf16, TestMode::BF16);
+    add(sel.test_fp16_widen, TestMode::FP16_Widen);
+    add(sel.test_bf16_widen, TestMode::BF16_Widen);
+    if (sel.test_mixed) {
+        modes += modes.empty() ? "mixed" : ",mixed";
+    }
+    return modes;
+}
+
+// ===================================================================
+// 随机测试桶
+// ===================================================================
+const std::vector<RandomBucket>& random_buckets(TestMode mode) {
+    switch (mode) {
+        case TestMode::FP32:       return fp32_random_buckets();
+        case TestMode::FP16:       return fp16_random_buckets();
+        case TestMode::BF16:       return bf16_random_buckets();
+        case TestMode::FP16_Widen: return fp16_widen_random_buckets();
+        case TestMode::BF16_Widen:
+        default:                   return bf16_widen_random_buckets();
+    }
+}
+
+static std::string range_name(const ExpRange& r) {
+    if (r.min > r.max) return "any";
+    char buf[32];
+    snprintf(buf, sizeof(buf), "[%d,%d]", r.min, r.max);
+    return buf;
+}
+
+std::string bucket_name(const RandomBucket& bucket) {
+    std::string name = std::string(test_mode_name(bucket.mode)) + " a" + range_name(bucket.a)
+                     + " b" + range_name(bucket.b);
+    if (bucket.mode == TestMode::FP16 || bucket.mode == TestMode::BF16) {
+        name += " a1" + range_name(bucket.a1) + " b1" + range_name(bucket.b1);
+    }
+    return name;
+}
+
+static uint32_t gen_fp32(const ExpRange& r) {
+    return r.min > r.max ? gen_any_fp32() : gen_random_fp32(r.min, r.max);
+}
+static uint16_t gen_fp16(const ExpRange& r) {
+    return r.min > r.max ? gen_any_fp16() : gen_random_fp16(r.min, r.max);
+}
+static uint16_t gen_bf16(const ExpRange& r) {
+    return r.min > r.max ? gen_any_bf16() : gen_random_bf16(r.min, r.max);
+}
+
+// 操作数按 a, b, a1, b1 的顺序生成 (花括号初始化保证从左到右求值)，
+// 与原先逐个桶展开的循环消耗 rand() 的顺序相同，相同 seed 生成的向量不变
+TestCase random_bucket_test(const RandomBucket& bucket) {
+    switch (bucket.mode) {
+        case TestMode::FP32:
+            return TestCase(FADD_Operands_Hex{gen_fp32(bucket.a), gen_fp32(bucket.b)}, bucket.error_type);
+        case TestMode::FP16: {
+            FADD_Operands_Hex_16 ops1 = {gen_fp16(bucket.a), gen_fp16(bucket.b)};
+            FADD_Operands_Hex_16 ops2 = {gen_fp16(bucket.a1), gen_fp16(bucket.b1)};
+            return TestCase(ops1, ops2, bucket.error_type);
+        }
+        case TestMode::BF16: {
+            FADD_Operands_Hex_BF16 ops1 = {gen_bf16(bucket.a), gen_bf16(bucket.b)};
+            FADD_Operands_Hex_BF16 ops2 = {gen_bf16(bucket.a1), gen_bf16(bucket.b1)};
+            return TestCase(ops1, ops2, bucket.error_type);
+        }
+        case TestMode::FP16_Widen:
+            return TestCase(FADD_Operands_FP16_Widen{gen_fp16(bucket.a), gen_fp16(bucket.b)}, bucket.error_type);
+        case TestMode::BF16_Widen:
+        default:
+            return TestCase(FADD_Operands_BF16_Widen{gen_bf16(bucket.a), gen_bf16(bucket.b)}, bucket.error_type);
+    }
+}
+
+void add_bucket_tests(std::vector<TestCase>& tests, const RandomBucket& bucket, int count) {
+    for (int i = 0; i < count; ++i) {
+        tests.push_back(random_bucket_test(bucket));
+    }
+}
+
+std::vector<TestCase> create_all_tests(const TestSelection& sel) {
+    TRACE_SCOPE("create_all_tests");
     std::vector<TestCase> tests;
   
-    bool test_fp32 = true;
-    bool test_fp16 = true;
-    bool test_bf16 = true;
-    bool test_fp16_widen = true;
-    bool test_bf16_widen = true;
-  
-    if (test_fp32) {
-        add_fp32_tests(tests);
+    if (sel.test_fp32) {
+        add_fp32_tests(tests, sel.num_random_tests);
     }
 
-    if (test_fp16) {
-        add_fp16_tests(tests);
+    if (sel.test_fp16) {
+        add_fp16_tests(tests, sel.num_random_tests);
     }
 
-    if (test_bf16) {
-        add_bf16_tests(tests);
+    if (sel.test_bf16) {
+        add_bf16_tests(tests, sel.num_random_tests);
     }
 
-    if (test_fp16_widen) {
-        add_fp16_widen_tests(tests);
+    if (sel.test_fp16_widen) {
+        add_fp16_widen_tests(tests, sel.num_random_tests);
     }
 
-    if (test_bf16_widen) {
-        add_bf16_widen_tests(tests);
+    if (sel.test_bf16_widen) {
+        add_bf16_widen_tests(tests, sel.num_random_tests);
+    }
+
+    if (sel.test_mixed) {
+        add_mixed_stream_tests(tests, sel.num_random_tests);
     }
 
     return tests;
-} 
\ No newline at end of file
+}
+
+uint64_t suite_digest(const std::vector<TestCase>& tests) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&](uint32_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            h = (h ^ ((v >> (8 * i)) & 0xFF)) * 0x100000001b3ull;
+        }
+    };
+    for (const TestCase& t : tests) {
+        mix((uint32_t)t.mode, 1);
+        mix((uint32_t)t.error_type, 1);
+        mix(t.a_bits, 4);
+        mix(t.b_bits, 4);
+    }
+    return h;
+}
@@ -3,7 +3,37 @@
 #include <vector>
 #include <cstdio>
 
-void add_bf16_tests(std::vector<TestCase>& tests) {
+// BF16 随机测试桶
+const std::vector<RandomBucket>& bf16_random_buckets() {
+    static const std::vector<RandomBucket> buckets = {
+        // ---- BF16 任意值随机测试 ----
+        {TestMode::BF16, kAnyValue, kAnyValue, kAnyValue, kAnyValue},
+        // ---- 进行不同指数范围的BF16随机测试 ----
+        // 小数范围测试：指数[-50, -10]
+        {TestMode::BF16, {-50, -10}, {-50, -10}, {-50, -10}, {-50, -10}},
+        // 中等数值范围测试：指数[-10, 10]
+        {TestMode::BF16, {-10, 10}, {-10, 10}, {-10, 10}, {-10, 10}},
+        // 大数范围测试：指数[10, 50]
+        {TestMode::BF16, {10, 50}, {10, 50}, {10, 50}, {10, 50}},
+        // 极端范围测试：指数[-126, 127]
+        {TestMode::BF16, {-126, 127}, {-126, 127}, {-126, 127}, {-126, 127}},
+        // 非规格化数边界测试：指数[-126, -125]
+        {TestMode::BF16, {-126, -125}, {-126, 20}, {-126, 20}, {-126, -125}},
+        // 混合精度范围测试
+        {TestMode::BF16, {-126, 20}, {-126, -125}, {-126, 20}, {-126, -125}},
+        // 高精度范围测试
+        {TestMode::BF16, {-126, -125}, {-126, -125}, {-126, -125}, {-126, -125}},
+        // 全范围混合测试
+        {TestMode::BF16, {-127, 10}, {-127, 10}, {-127, 10}, {-127, 10}},
+        // 相对误差测试（较高精度要求）
+        {TestMode::BF16, {-20, 20}, {-20, 20}, {-20, 20}, {-20, 20}, 5},
+        // 极端范围测试：指数[-127, -126]
+        {TestMode::BF16, {-127, -126}, {-127, -126}, {-127, -126}, {-127, -126}},
+    };
+    return buckets;
+}
+
+void add_bf16_tests(std::vector<TestCase>& tests, int num_random_tests) {
     // -- BF16 并行双路半精度浮点数测试 --
     tests.push_back(TestCase(FADD_Operands_Hex_BF16{0x3f80, 0x4000}, FADD_Operands_Hex_BF16{0x4040, 0x3f80}, ErrorType::Precise)); // 1.0 + 2.0 = 3.0 | 3.0 + 1.0 = 4.0
     tests.push_back(TestCase(FADD_Operands_Hex_BF16{0xbf80, 0x4000}, FADD_Operands_Hex_BF16{0x3f80, 0xc000}, ErrorType::Precise)); // -1.0 + 2.0 = 1.0 | 1.0 + -2.0 = -1.0
@@ -41,74 +71,7 @@ void add_bf16_tests(std::vector<TestCase>& tests) {
     tests.push_back(TestCase(FADD_Operands_Hex_BF16{0xb0f, 0xf7f}, FADD_Operands_Hex_BF16{0xb0f, 0xf7f}, ErrorType::Precise));
 
     printf("\n---- Random tests for BF16 ----\n");
-    int num_random_tests_bf16 = 200;
-    ErrorType default_error_type = ErrorType::Precise;
-    // ---- BF16 任意值随机测试 ----
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_any_bf16(), gen_any_bf16()};
-        FADD_Operands_Hex_BF16 ops2 = {gen_any_bf16(), gen_any_bf16()};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    
-    // ---- 进行不同指数范围的BF16随机测试 ----
-    // 小数范围测试：指数[-50, -10]
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-50, -10), gen_random_bf16(-50, -10)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-50, -10), gen_random_bf16(-50, -10)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 中等数值范围测试：指数[-10, 10]
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-10, 10), gen_random_bf16(-10, 10)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-10, 10), gen_random_bf16(-10, 10)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 大数范围测试：指数[10, 50]
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(10, 50), gen_random_bf16(10, 50)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(10, 50), gen_random_bf16(10, 50)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 极端范围测试：指数[-126, 127]
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-126, 127), gen_random_bf16(-126, 127)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-126, 127), gen_random_bf16(-126, 127)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 非规格化数边界测试：指数[-126, -125]
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-126, -125), gen_random_bf16(-126, 20)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-126, 20), gen_random_bf16(-126, -125)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 混合精度范围测试
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-126, 20), gen_random_bf16(-126, -125)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-126, 20), gen_random_bf16(-126, -125)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 高精度范围测试
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-126, -125), gen_random_bf16(-126, -125)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-126, -125), gen_random_bf16(-126, -125)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 全范围混合测试
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-127, 10), gen_random_bf16(-127, 10)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-127, 10), gen_random_bf16(-127, 10)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 相对误差测试（较高精度要求）
-    for (int i = 0; i < num_random_tests_bf16 / 5; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-20, 20), gen_random_bf16(-20, 20)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-20, 20), gen_random_bf16(-20, 20)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 极端范围测试：指数[-127, -126]
-    for (int i = 0; i < num_random_tests_bf16; ++i) {
-        FADD_Operands_Hex_BF16 ops1 = {gen_random_bf16(-127, -126), gen_random_bf16(-127, -126)};
-        FADD_Operands_Hex_BF16 ops2 = {gen_random_bf16(-127, -126), gen_random_bf16(-127, -126)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
+    for (const RandomBucket& bucket : bf16_random_buckets()) {
+        add_bucket_tests(tests, bucket, num_random_tests / bucket.count_divisor);
     }
 } 
\ No newline at end of file
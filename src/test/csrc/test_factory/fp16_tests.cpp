@@ -3,7 +3,28 @@
 #include <vector>
 #include <cstdio>
 
-void add_fp16_tests(std::vector<TestCase>& tests) {
+// FP16 随机测试桶
+const std::vector<RandomBucket>& fp16_random_buckets() {
+    static const std::vector<RandomBucket> buckets = {
+        // ---- FP16 任意值随机测试 ----
+        {TestMode::FP16, kAnyValue, kAnyValue, kAnyValue, kAnyValue},
+        // ---- 进行不同指数范围的FP16随机测试 ----
+        // 小数范围测试：指数[-15, -5]
+        {TestMode::FP16, {-15, -5}, {-15, -5}, {-15, -5}, {-15, -5}},
+        // 中等数值范围测试：指数[-5, 5]
+        {TestMode::FP16, {-5, 5}, {-5, 5}, {-5, 5}, {-5, 5}},
+        // 大数范围测试：指数[5, 15]
+        {TestMode::FP16, {5, 15}, {5, 15}, {5, 15}, {5, 15}},
+        // 更多测试
+        {TestMode::FP16, {-15, 15}, {-15, 15}, {-15, 15}, {-15, 15}},
+        {TestMode::FP16, {-15, -14}, {-15, 15}, {-15, 15}, {-15, -14}},
+        {TestMode::FP16, {-15, 15}, {-15, -14}, {-15, 15}, {-15, -14}},
+        {TestMode::FP16, {-15, -14}, {-15, -14}, {-15, -14}, {-15, -14}},
+    };
+    return buckets;
+}
+
+void add_fp16_tests(std::vector<TestCase>& tests, int num_random_tests) {
     // -- FP16 并行双路半精度浮点数测试 --
     tests.push_back(TestCase(FADD_Operands_Hex_16{0x3c00, 0x4000}, FADD_Operands_Hex_16{0x4200, 0x3c00}, ErrorType::Precise)); // 1.0 + 2.0 = 3.0 | 3.0 + 1.0 = 4.0
     tests.push_back(TestCase(FADD_Operands_Hex_16{0xbc00, 0x4000}, FADD_Operands_Hex_16{0x3c00, 0xc000}, ErrorType::Precise)); // -1.0 + 2.0 = 1.0 | 1.0 + -2.0 = -1.0
@@ -26,52 +47,7 @@ void add_fp16_tests(std::vector<TestCase>& tests) {
     tests.push_back(TestCase(FADD_Operands_Hex_16{0x1f00, 0x4163}, FADD_Operands_Hex_16{0x7445, 0x5adb}, ErrorType::Precise));
 
     printf("\n---- Random tests for FP16 ----\n");
-    int num_random_tests_16 = 200;
-    ErrorType default_error_type = ErrorType::Precise;
-    // ---- FP16 任意值随机测试 ----
-    for (int i = 0; i < num_random_tests_16; ++i) {
-        FADD_Operands_Hex_16 ops1 = {gen_any_fp16(), gen_any_fp16()};
-        FADD_Operands_Hex_16 ops2 = {gen_any_fp16(), gen_any_fp16()};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // ---- 进行不同指数范围的FP16随机测试 ----
-    // 小数范围测试：指数[-15, -5]
-    for (int i = 0; i < num_random_tests_16; ++i) {
-        FADD_Operands_Hex_16 ops1 = {gen_random_fp16(-15, -5), gen_random_fp16(-15, -5)};
-        FADD_Operands_Hex_16 ops2 = {gen_random_fp16(-15, -5), gen_random_fp16(-15, -5)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 中等数值范围测试：指数[-5, 5]
-    for (int i = 0; i < num_random_tests_16; ++i) {
-        FADD_Operands_Hex_16 ops1 = {gen_random_fp16(-5, 5), gen_random_fp16(-5, 5)};
-        FADD_Operands_Hex_16 ops2 = {gen_random_fp16(-5, 5), gen_random_fp16(-5, 5)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 大数范围测试：指数[5, 15]
-    for (int i = 0; i < num_random_tests_16; ++i) {
-        FADD_Operands_Hex_16 ops1 = {gen_random_fp16(5, 15), gen_random_fp16(5, 15)};
-        FADD_Operands_Hex_16 ops2 = {gen_random_fp16(5, 15), gen_random_fp16(5, 15)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    // 更多测试
-    for (int i = 0; i < num_random_tests_16; ++i) {
-        FADD_Operands_Hex_16 ops1 = {gen_random_fp16(-15, 15), gen_random_fp16(-15, 15)};
-        FADD_Operands_Hex_16 ops2 = {gen_random_fp16(-15, 15), gen_random_fp16(-15, 15)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_16; ++i) {
-        FADD_Operands_Hex_16 ops1 = {gen_random_fp16(-15, -14), gen_random_fp16(-15, 15)};
-        FADD_Operands_Hex_16 ops2 = {gen_random_fp16(-15, 15), gen_random_fp16(-15, -14)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_16; ++i) {
-        FADD_Operands_Hex_16 ops1 = {gen_random_fp16(-15, 15), gen_random_fp16(-15, -14)};
-        FADD_Operands_Hex_16 ops2 = {gen_random_fp16(-15, 15), gen_random_fp16(-15, -14)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_16; ++i) {
-        FADD_Operands_Hex_16 ops1 = {gen_random_fp16(-15, -14), gen_random_fp16(-15, -14)};
-        FADD_Operands_Hex_16 ops2 = {gen_random_fp16(-15, -14), gen_random_fp16(-15, -14)};
-        tests.push_back(TestCase(ops1, ops2, default_error_type));
+    for (const RandomBucket& bucket : fp16_random_buckets()) {
+        add_bucket_tests(tests, bucket, num_random_tests / bucket.count_divisor);
     }
 } 
\ No newline at end of file
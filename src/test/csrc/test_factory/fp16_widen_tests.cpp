@@ -3,7 +3,40 @@
 #include <vector>
 #include <cstdio>
 
-void add_fp16_widen_tests(std::vector<TestCase>& tests) {
+// FP16 Widen 随机测试桶
+const std::vector<RandomBucket>& fp16_widen_random_buckets() {
+    static const std::vector<RandomBucket> buckets = {
+        // ---- FP16 widen 任意值随机测试 ----
+        {TestMode::FP16_Widen, kAnyValue, kAnyValue},
+        // 更多不同范围的随机测试...
+        // 正常范围测试
+        {TestMode::FP16_Widen, {-10, 10}, {-10, 10}},
+        // 小数范围测试 - FP16指数范围
+        {TestMode::FP16_Widen, {-15, -5}, {-15, -5}},
+        // 大数范围测试 - FP16指数范围
+        {TestMode::FP16_Widen, {5, 15}, {5, 15}},
+        // 混合指数范围测试
+        {TestMode::FP16_Widen, {-15, 15}, {-15, 15}},
+        // 非规格化数边界测试 - FP16
+        {TestMode::FP16_Widen, {-15, -14}, {-15, 15}},
+        {TestMode::FP16_Widen, {-15, 15}, {-15, -14}},
+        // 极端范围测试 - 接近FP16溢出
+        {TestMode::FP16_Widen, {14, 15}, {14, 15}},
+        // 极端下溢测试 - 接近FP16下溢
+        {TestMode::FP16_Widen, {-15, -14}, {-15, -14}},
+        // 高精度FP32 c值测试
+        {TestMode::FP16_Widen, {-5, 5}, {-5, 5}},
+        {TestMode::FP16_Widen, {-5, 5}, {-5, 5}},
+        // 全范围随机测试 - 最全面的测试
+        {TestMode::FP16_Widen, {-15, 15}, {-15, 15}},
+        // 特殊组合测试 - 一个操作数极大，另一个极小
+        {TestMode::FP16_Widen, {10, 15}, {-15, -10}},
+        {TestMode::FP16_Widen, {-15, -10}, {10, 15}},
+    };
+    return buckets;
+}
+
+void add_fp16_widen_tests(std::vector<TestCase>& tests, int num_random_tests) {
     // -- FP16 widen 测试 --
     tests.push_back(TestCase(FADD_Operands_FP16_Widen{0x3c00, 0x4000}, ErrorType::Precise)); // 1.0 + 2.0 = 3.0
     tests.push_back(TestCase(FADD_Operands_FP16_Widen{0xbc00, 0x4000}, ErrorType::Precise)); // -1.0 + 2.0 = 1.0
@@ -12,74 +45,7 @@ void add_fp16_widen_tests(std::vector<TestCase>& tests) {
     tests.push_back(TestCase(FADD_Operands_FP16_Widen{0x008e, 0x8000}, ErrorType::Precise)); // 0.00000846 + -0.00000000 = 0.00000846
   
     printf("\n---- Random tests for FP16 Widen ----\n");
-    int num_random_tests_fp16_widen = 200;
-    ErrorType default_error_type = ErrorType::Precise;
-    // ---- FP16 widen 任意值随机测试 ----
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_any_fp16(), gen_any_fp16()};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 更多不同范围的随机测试...
-    // 正常范围测试
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-10, 10), gen_random_fp16(-10, 10)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 小数范围测试 - FP16指数范围
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-15, -5), gen_random_fp16(-15, -5)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 大数范围测试 - FP16指数范围  
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(5, 15), gen_random_fp16(5, 15)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 混合指数范围测试
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-15, 15), gen_random_fp16(-15, 15)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 非规格化数边界测试 - FP16
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-15, -14), gen_random_fp16(-15, 15)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-15, 15), gen_random_fp16(-15, -14)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 极端范围测试 - 接近FP16溢出
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(14, 15), gen_random_fp16(14, 15)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 极端下溢测试 - 接近FP16下溢
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-15, -14), gen_random_fp16(-15, -14)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 高精度FP32 c值测试
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-5, 5), gen_random_fp16(-5, 5)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-5, 5), gen_random_fp16(-5, 5)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 全范围随机测试 - 最全面的测试
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-15, 15), gen_random_fp16(-15, 15)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 特殊组合测试 - 一个操作数极大，另一个极小
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(10, 15), gen_random_fp16(-15, -10)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_fp16_widen; ++i) {
-        FADD_Operands_FP16_Widen ops = {gen_random_fp16(-15, -10), gen_random_fp16(10, 15)};
-        tests.push_back(TestCase(ops, default_error_type));
+    for (const RandomBucket& bucket : fp16_widen_random_buckets()) {
+        add_bucket_tests(tests, bucket, num_random_tests / bucket.count_divisor);
     }
 } 
\ No newline at end of file
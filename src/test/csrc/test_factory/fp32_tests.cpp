@@ -3,7 +3,28 @@
 #include <vector>
 #include <cstdio>
 
-void add_fp32_tests(std::vector<TestCase>& tests) {
+// FP32 随机测试桶
+const std::vector<RandomBucket>& fp32_random_buckets() {
+    static const std::vector<RandomBucket> buckets = {
+        // ---- FP32 任意值随机测试 ----
+        {TestMode::FP32, kAnyValue, kAnyValue},
+        // ---- 进行不同指数范围的测试 ----
+        // 小数范围测试：指数[-50, -10]
+        {TestMode::FP32, {-50, -10}, {-50, -10}},
+        // 中等数值范围测试：指数[-10, 10]
+        {TestMode::FP32, {-10, 10}, {-10, 10}},
+        // 大数范围测试：指数[10, 50]
+        {TestMode::FP32, {10, 50}, {10, 50}},
+        // 更多测试
+        {TestMode::FP32, {-126, 20}, {-126, 20}},
+        {TestMode::FP32, {-126, 20}, {-127, -126}},
+        {TestMode::FP32, {-127, -126}, {-126, 20}},
+        {TestMode::FP32, {-127, 10}, {-127, 10}},
+    };
+    return buckets;
+}
+
+void add_fp32_tests(std::vector<TestCase>& tests, int num_random_tests) {
     // -- FP32 单精度浮点数测试 --
     tests.push_back(TestCase(FADD_Operands_Hex{0xC0A00000, 0xC0E00000}, ErrorType::Precise)); // -5.0f + -7.0f = -12.0f
     tests.push_back(TestCase(FADD_Operands_Hex{0x3F800000, 0x40000000}, ErrorType::Precise)); // 1.0f + 2.0f = 3.0f
@@ -20,45 +41,8 @@ void add_fp32_tests(std::vector<TestCase>& tests) {
     tests.push_back(TestCase(FADD_Operands_Hex{0x816849E7, 0x00B6D8A2}, ErrorType::Precise));
     tests.push_back(TestCase(FADD_Operands_Hex{0x80000000, 0x80000000}, ErrorType::Precise)); // -0.0f + -0.0f = -0.0f
 
-    int num_random_tests_32 = 200;
-    ErrorType default_error_type = ErrorType::Precise;
     printf("\n---- Random tests for FP32 ----\n");
-    // ---- FP32 任意值随机测试 ----
-    for (int i = 0; i < num_random_tests_32; ++i) {
-        FADD_Operands_Hex ops = {gen_any_fp32(), gen_any_fp32()};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // ---- 进行不同指数范围的测试 ----
-    // 小数范围测试：指数[-50, -10]
-    for (int i = 0; i < num_random_tests_32; ++i) {
-        FADD_Operands_Hex ops = {gen_random_fp32(-50, -10), gen_random_fp32(-50, -10)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 中等数值范围测试：指数[-10, 10]
-    for (int i = 0; i < num_random_tests_32; ++i) {
-        FADD_Operands_Hex ops = {gen_random_fp32(-10, 10), gen_random_fp32(-10, 10)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 大数范围测试：指数[10, 50]
-    for (int i = 0; i < num_random_tests_32; ++i) {
-        FADD_Operands_Hex ops = {gen_random_fp32(10, 50), gen_random_fp32(10, 50)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    // 更多测试
-    for (int i = 0; i < num_random_tests_32; ++i) {
-        FADD_Operands_Hex ops = {gen_random_fp32(-126, 20), gen_random_fp32(-126, 20)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_32; ++i) {
-        FADD_Operands_Hex ops = {gen_random_fp32(-126, 20), gen_random_fp32(-127, -126)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_32; ++i) {
-        FADD_Operands_Hex ops = {gen_random_fp32(-127, -126), gen_random_fp32(-126, 20)};
-        tests.push_back(TestCase(ops, default_error_type));
-    }
-    for (int i = 0; i < num_random_tests_32; ++i) {
-        FADD_Operands_Hex ops = {gen_random_fp32(-127, 10), gen_random_fp32(-127, 10)};
-        tests.push_back(TestCase(ops, default_error_type));
+    for (const RandomBucket& bucket : fp32_random_buckets()) {
+        add_bucket_tests(tests, bucket, num_random_tests / bucket.count_divisor);
     }
 } 
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "../include/test_factory.h"
+#include "../include/fp_utils.h"
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+// 生成一个指定模式的任意值随机测试
+// 两路操作数先生成到局部变量: 函数实参的求值顺序未指定，同一 seed 在不同编译器下会得到不同的向量
+static TestCase random_test(TestMode mode, ErrorType error_type) {
+    switch (mode) {
+        case TestMode::FP32:
+            return TestCase(FADD_Operands_Hex{gen_any_fp32(), gen_any_fp32()}, error_type);
+        case TestMode::FP16: {
+            FADD_Operands_Hex_16 ops1 = {gen_any_fp16(), gen_any_fp16()};
+            FADD_Operands_Hex_16 ops2 = {gen_any_fp16(), gen_any_fp16()};
+            return TestCase(ops1, ops2, error_type);
+        }
+        case TestMode::BF16: {
+            FADD_Operands_Hex_BF16 ops1 = {gen_any_bf16(), gen_any_bf16()};
+            FADD_Operands_Hex_BF16 ops2 = {gen_any_bf16(), gen_any_bf16()};
+            return TestCase(ops1, ops2, error_type);
+        }
+        case TestMode::FP16_Widen:
+            return TestCase(FADD_Operands_FP16_Widen{gen_any_fp16(), gen_any_fp16()}, error_type);
+        case TestMode::BF16_Widen:
+        default:
+            return TestCase(FADD_Operands_BF16_Widen{gen_any_bf16(), gen_any_bf16()}, error_type);
+    }
+}
+
+void add_mixed_stream_tests(std::vector<TestCase>& tests, int num_random_tests) {
+    // -- 混合模式流水线测试: 每个周期切换格式 --
+    // 需配合 --stream 使用，相邻操作背靠背进入 FAdd_16_32 流水线
+    const TestMode modes[] = {TestMode::FP32, TestMode::BF16, TestMode::FP16_Widen,
+                              TestMode::FP16, TestMode::BF16_Widen};
+    const int num_modes = sizeof(modes) / sizeof(modes[0]);
+    ErrorType default_error_type = ErrorType::Precise;
+
+    printf("\n---- Mixed-mode stream tests ----\n");
+    // 固定轮转: FP32 -> BF16 -> FP16 widen -> FP16 -> BF16 widen -> ...
+    for (int i = 0; i < num_random_tests; ++i) {
+        tests.push_back(random_test(modes[i % num_modes], default_error_type));
+    }
+    // 覆盖所有有序模式对 (a -> b)，包括相同模式
+    for (int a = 0; a < num_modes; ++a) {
+        for (int b = 0; b < num_modes; ++b) {
+            tests.push_back(random_test(modes[a], default_error_type));
+            tests.push_back(random_test(modes[b], default_error_type));
+        }
+    }
+    // 随机模式序列
+    for (int i = 0; i < num_random_tests * 4; ++i) {
+        tests.push_back(random_test(modes[rand() % num_modes], default_error_type));
+    }
+}
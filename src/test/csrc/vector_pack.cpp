@@ -0,0 +1,60 @@
+#include "include/vector_pack.h"
+
+#include <cstdio>
+
+using namespace std;
+
+bool write_vector_pack(const string& path, const vector<TestCase>& tests) {
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) {
+        printf("Cannot open vector pack %s\n", path.c_str());
+        return false;
+    }
+    VectorPackHeader header = {kVectorPackMagic, kVectorPackVersion, tests.size()};
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+           && fwrite(tests.data(), sizeof(TestCase), tests.size(), fp) == tests.size();
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok) {
+        printf("Failed to write vector pack %s\n", path.c_str());
+    }
+    return ok;
+}
+
+bool read_vector_pack(const string& path, vector<TestCase>& tests) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        printf("Cannot open vector pack %s\n", path.c_str());
+        return false;
+    }
+    VectorPackHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != kVectorPackMagic
+        || header.version != kVectorPackVersion) {
+        printf("Invalid vector pack %s\n", path.c_str());
+        fclose(fp);
+        return false;
+    }
+    // 记录数由剩余文件长度确认后再分配，损坏的 count 不会触发巨大的分配
+    long records_pos = ftell(fp);
+    long file_size = (records_pos >= 0 && fseek(fp, 0, SEEK_END) == 0) ? ftell(fp) : -1;
+    if (file_size < records_pos || fseek(fp, records_pos, SEEK_SET) != 0
+        || header.count != (uint64_t)(file_size - records_pos) / sizeof(TestCase)
+        || (uint64_t)(file_size - records_pos) % sizeof(TestCase) != 0) {
+        printf("Truncated or corrupt vector pack %s: header claims %llu vectors\n", path.c_str(),
+               (unsigned long long)header.count);
+        fclose(fp);
+        return false;
+    }
+    // 先用占位向量分配空间，再整体读入记录
+    tests.assign(header.count, TestCase(FADD_Operands_Hex{0, 0}));
+    bool ok = fread(tests.data(), sizeof(TestCase), tests.size(), fp) == tests.size();
+    fclose(fp);
+    for (size_t i = 0; ok && i < tests.size(); ++i) {
+        ok = (int)tests[i].mode <= (int)TestMode::BF16_Widen
+          && (int)tests[i].error_type <= (int)ErrorType::ULP_or_RelativeError;
+    }
+    if (!ok) {
+        printf("Truncated or corrupt vector pack %s\n", path.c_str());
+        tests.clear();
+    }
+    return ok;
+}
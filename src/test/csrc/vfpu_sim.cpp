@@ -0,0 +1,164 @@
+#include "include/vfpu_sim.h"
+#include "include/simulator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+const size_t kLibBatchSize = 4096; // 每次 run_batch 的拍数
+
+struct vfpu_sim {
+    unique_ptr<Simulator> sim;
+    vector<TestCase> beats;
+    vector<DutOutputs> outputs;
+};
+
+int vfpu_sim_api_version(void) {
+    return VFPU_SIM_API_VERSION;
+}
+
+vfpu_sim* vfpu_sim_create(void) {
+    // 库只需要DUT输出，不计算参考结果
+    set_reference_enabled(false);
+    static char prog[] = "libvfpu_sim";
+    char* argv[] = { prog, nullptr };
+    vfpu_sim* s = new (nothrow) vfpu_sim;
+    if (!s) return nullptr;
+    try {
+        s->sim.reset(new Simulator(1, argv));
+    } catch (...) {
+        delete s;
+        return nullptr;
+    }
+    s->beats.assign(kLibBatchSize, TestCase(FADD_Operands_Hex{0, 0}, ErrorType::Precise));
+    s->outputs.resize(kLibBatchSize);
+    return s;
+}
+
+void vfpu_sim_destroy(vfpu_sim* sim) {
+    delete sim;
+}
+
+Simulator* vfpu_sim_simulator(vfpu_sim* sim) {
+    return sim->sim.get();
+}
+
+static inline uint16_t load16(const void* p, size_t i) {
+    uint16_t v;
+    memcpy(&v, (const char*)p + 2 * i, 2);
+    return v;
+}
+
+static inline uint32_t load32(const void* p, size_t i) {
+    uint32_t v;
+    memcpy(&v, (const char*)p + 4 * i, 4);
+    return v;
+}
+
+static inline void store16(void* p, size_t i, uint16_t v) {
+    memcpy((char*)p + 2 * i, &v, 2);
+}
+
+static inline void store32(void* p, size_t i, uint32_t v) {
+    memcpy((char*)p + 4 * i, &v, 4);
+}
+
+// 把元素 [first, first + count) 打包成拍，写入 s->beats[0, 返回值)
+static size_t pack_beats(vfpu_sim* s, TestMode mode, const void* a, const void* b, size_t first, size_t count) {
+    size_t n = 0;
+    switch (mode) {
+        case TestMode::FP32:
+            for (size_t i = 0; i < count; ++i, ++n) {
+                s->beats[n].a_bits = load32(a, first + i);
+                s->beats[n].b_bits = load32(b, first + i);
+            }
+            break;
+        case TestMode::FP16:
+        case TestMode::BF16:
+            for (size_t i = 0; i < count; i += 2, ++n) {
+                bool pair = i + 1 < count;
+                s->beats[n].a_bits = load16(a, first + i) | (pair ? (uint32_t)load16(a, first + i + 1) << 16 : 0);
+                s->beats[n].b_bits = load16(b, first + i) | (pair ? (uint32_t)load16(b, first + i + 1) << 16 : 0);
+            }
+            break;
+        default: // Widen: 操作数位于高16位
+            for (size_t i = 0; i < count; ++i, ++n) {
+                s->beats[n].a_bits = (uint32_t)load16(a, first + i) << 16;
+                s->beats[n].b_bits = (uint32_t)load16(b, first + i) << 16;
+            }
+            break;
+    }
+    for (size_t k = 0; k < n; ++k) {
+        s->beats[k].mode = mode;
+    }
+    return n;
+}
+
+static void unpack_results(vfpu_sim* s, TestMode mode, void* out, size_t first, size_t count) {
+    if (mode == TestMode::FP16 || mode == TestMode::BF16) {
+        for (size_t i = 0; i < count; ++i) {
+            const DutOutputs& o = s->outputs[i / 2];
+            store16(out, first + i, (i & 1) ? o.res_out_16_1 : o.res_out_16_0);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            store32(out, first + i, s->outputs[i].res_out_32);
+        }
+    }
+}
+
+int vfpu_sim_add(vfpu_sim* sim, vfpu_mode mode, const void* a, const void* b, void* out, size_t n) {
+    if (!sim || (unsigned)mode >= (unsigned)kNumTestModes || (n && (!a || !b || !out))) {
+        return VFPU_ERR_ARG;
+    }
+    const TestMode m = (TestMode)mode;
+    const size_t per_beat = (m == TestMode::FP16 || m == TestMode::BF16) ? 2 : 1;
+    const size_t chunk = kLibBatchSize * per_beat;
+    for (size_t first = 0; first < n; first += chunk) {
+        size_t count = min(chunk, n - first);
+        size_t beats = pack_beats(sim, m, a, b, first, count);
+        if (!sim->sim->run_batch(sim->beats.data(), beats, sim->outputs.data())) {
+            return VFPU_ERR_TIMEOUT;
+        }
+        unpack_results(sim, m, out, first, count);
+    }
+    return VFPU_OK;
+}
+
+// 默认实例: 第一次调用时创建，进程退出时销毁
+static mutex default_lock;
+static unique_ptr<vfpu_sim, void (*)(vfpu_sim*)> default_sim(nullptr, vfpu_sim_destroy);
+
+static int add_default(vfpu_mode mode, const void* a, const void* b, void* out, size_t n) {
+    lock_guard<mutex> guard(default_lock);
+    if (!default_sim) {
+        default_sim.reset(vfpu_sim_create());
+        if (!default_sim) return VFPU_ERR_INIT;
+    }
+    return vfpu_sim_add(default_sim.get(), mode, a, b, out, n);
+}
+
+int vfpu_add_fp32(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n) {
+    return add_default(VFPU_MODE_FP32, a, b, out, n);
+}
+
+int vfpu_add_fp16(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n) {
+    return add_default(VFPU_MODE_FP16, a, b, out, n);
+}
+
+int vfpu_add_bf16(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n) {
+    return add_default(VFPU_MODE_BF16, a, b, out, n);
+}
+
+int vfpu_add_fp16_widen(const uint16_t* a, const uint16_t* b, uint32_t* out, size_t n) {
+    return add_default(VFPU_MODE_FP16_WIDEN, a, b, out, n);
+}
+
+int vfpu_add_bf16_widen(const uint16_t* a, const uint16_t* b, uint32_t* out, size_t n) {
+    return add_default(VFPU_MODE_BF16_WIDEN, a, b, out, n);
+}